@@ -5,12 +5,15 @@
 #include <AbstractPlatform/i2c/AbstractI2C.hpp>
 #include <AbstractPlatform/output/display/AbstractDisplay.hpp>
 #include <ExternalHardware/ssd1306/SSD1306_HAL.hpp>
+#include <ExternalHardware/ssd1306/SSD1306_BitmapConversion.hpp>
 
 #include <cassert>
 #include <memory>
 #include <cstring>
 #include <utility>
 #include <cmath>
+#include <algorithm>
+#include <limits>
 
 namespace ExternalHardware
 {
@@ -19,10 +22,8 @@ namespace Ssd1306
 template < typename taDisplayType = Ssd1306128x32 >
 class CSsd1306
 {
-private:
-    using TSsd1306Hal = CSsd1306Hal< taDisplayType >;
-
 public:
+    using TSsd1306Hal = CSsd1306Hal< taDisplayType >;
     using TPage = typename TSsd1306Hal::TPage;
     using TErrorCode = AbstractPlatform::TErrorCode;
     using TPixel = AbstractPlatform::TBitPixel;
@@ -36,10 +37,35 @@ public:
     {
     }
 
+    CSsd1306( IScatterGatherI2CBus& aI2CBus,
+              std::uint8_t aDeviceAddress = TSsd1306Hal::KDefaultAddress ) NOEXCEPT
+        : iSsd1306Hal{ aI2CBus, aDeviceAddress }
+    {
+    }
+
+    /**
+     * @brief Construct the display on the transport of its type, e.g. the CSsd1306SpiTransport
+     * of a TSpiDisplay.
+     */
+    explicit CSsd1306( const typename TSsd1306Hal::TTransport& aTransport ) NOEXCEPT
+        : iSsd1306Hal{ aTransport }
+    {
+    }
+
     inline TErrorCode
-    Init( )
+    Init( bool aClearRam = true )
+    {
+        return iSsd1306Hal.Init( aClearRam );
+    }
+
+    /**
+     * @brief Gives access to the display commands not covered by the render API (scrolling,
+     * contrast, start line etc.).
+     */
+    inline TSsd1306Hal&
+    Hal( ) NOEXCEPT
     {
-        return iSsd1306Hal.Init( );
+        return iSsd1306Hal;
     }
 
     class CRenderAreaNavigation : virtual public TAbstractCanvasNavigation
@@ -84,6 +110,8 @@ public:
             , iRows{ Rows( aBeginPage, aLastPage ) }
             , iCurrentPageIndex{ 0 }
             , iCurrentPagePixelBitIndex{ 0 }
+            , iCurrentColumn{ 0 }
+            , iCurrentRow{ 0 }
 
         {
         }
@@ -115,9 +143,8 @@ public:
         inline TPosition
         GetPositionImpl( ) const
         {
-            const size_t x = iCurrentPageIndex % iColumns;
-            const size_t y = iCurrentPageIndex / iColumns * TSsd1306Hal::KPixelsPerPage
-                             + iCurrentPagePixelBitIndex;
+            const size_t x = iCurrentColumn;
+            const size_t y = iCurrentRow * TSsd1306Hal::KPixelsPerPage + iCurrentPagePixelBitIndex;
             const TPosition result{ static_cast< int >( x ), static_cast< int >( y ) };
             return result;
         }
@@ -132,6 +159,8 @@ public:
 
             iCurrentPageIndex = GetPageIndexByPixelCoordinate( aX, aY );
             iCurrentPagePixelBitIndex = GetPagePixelBitIndexByPixelYCoordinate( aY );
+            iCurrentColumn = static_cast< std::uint8_t >( aX );
+            iCurrentRow = static_cast< std::uint8_t >( aY / TSsd1306Hal::KPixelsPerPage );
         }
 
         inline size_t
@@ -160,25 +189,40 @@ public:
         const std::uint8_t iRows;
         size_t iCurrentPageIndex;
         std::uint8_t iCurrentPagePixelBitIndex;
+        std::uint8_t iCurrentColumn;
+        std::uint8_t iCurrentRow;
     };
 
-    class CRenderArea : public TAbstractCanvas, public CRenderAreaNavigation
+    /**
+     * @brief The render area implementation independent of the way its buffer is stored. The
+     * buffer holds just the page-major display data, the data control byte is added by the
+     * transfer: gathered by the bus, written to the headroom byte preceding the buffer if the
+     * storage has one, or copied together with the data otherwise. The D/C line transports
+     * send the buffer as it is.
+     */
+    class CRenderAreaBase : public TAbstractCanvas, public CRenderAreaNavigation
     {
     public:
         using TPixel = typename TAbstractCanvas::TPixel;
         using TPosition = typename CRenderAreaNavigation::TPosition;
 
-        CRenderArea( CRenderArea&& ) = default;
-        virtual ~CRenderArea( ) = default;
+        virtual ~CRenderAreaBase( ) = default;
 
         void
         SetPixel( TPixel aPixelValue ) NOEXCEPT override
         {
             using namespace AbstractPlatform;
             auto& page = DisplayBuffer( )[ CRenderAreaNavigation::iCurrentPageIndex ];
-            page = aPixelValue.iPixelValue
-                       ? SetBit( page, CRenderAreaNavigation::iCurrentPagePixelBitIndex )
-                       : ClearBit( page, CRenderAreaNavigation::iCurrentPagePixelBitIndex );
+            const TPage newPage
+                = aPixelValue.iPixelValue
+                      ? SetBit( page, CRenderAreaNavigation::iCurrentPagePixelBitIndex )
+                      : ClearBit( page, CRenderAreaNavigation::iCurrentPagePixelBitIndex );
+            if ( newPage != page )
+            {
+                page = newPage;
+                MarkDirty( CRenderAreaNavigation::iCurrentColumn,
+                           CRenderAreaNavigation::iCurrentRow );
+            }
         }
 
         TPixel
@@ -194,6 +238,20 @@ public:
         {
             std::memset( DisplayBuffer( ), aValue.iPixelValue ? 0xFF : 0x00,
                          GetDisplayBufferSize( ) );
+            MarkAllDirty( );
+        }
+
+        /**
+         * @brief Copies the content of another render area of the same size.
+         */
+        void
+        CopyFrom( const CRenderAreaBase& aRenderArea ) NOEXCEPT
+        {
+            assert( aRenderArea.Columns( ) == Columns( ) );
+            assert( aRenderArea.Rows( ) == Rows( ) );
+
+            std::memcpy( DisplayBuffer( ), aRenderArea.DisplayBuffer( ), GetDisplayBufferSize( ) );
+            MarkAllDirty( );
         }
 
         constexpr size_t
@@ -208,6 +266,30 @@ public:
             return CRenderAreaNavigation::iColumns;
         }
 
+        constexpr std::uint8_t
+        BeginColumn( ) const NOEXCEPT
+        {
+            return CRenderAreaNavigation::iBeginColumn;
+        }
+
+        constexpr std::uint8_t
+        LastColumn( ) const NOEXCEPT
+        {
+            return CRenderAreaNavigation::iLastColumn;
+        }
+
+        constexpr std::uint8_t
+        BeginPage( ) const NOEXCEPT
+        {
+            return CRenderAreaNavigation::iBeginPage;
+        }
+
+        constexpr std::uint8_t
+        LastPage( ) const NOEXCEPT
+        {
+            return CRenderAreaNavigation::iLastPage;
+        }
+
         void
         SetPage( size_t aColumnIndex, size_t aPageIndex, TPage aPage )
         {
@@ -216,7 +298,305 @@ public:
 
             const auto pageIndex = aPageIndex * CRenderAreaNavigation::iColumns + aColumnIndex;
             auto& page = DisplayBuffer( )[ pageIndex ];
-            page = aPage;
+            if ( page != aPage )
+            {
+                page = aPage;
+                MarkDirty( static_cast< std::uint8_t >( aColumnIndex ),
+                           static_cast< std::uint8_t >( aPageIndex ) );
+            }
+        }
+
+        // Bulk drawing operations. Unlike the canvas interface they are not virtual, work on
+        // whole pages at once and clip the drawing to the render area.
+
+        inline void
+        DrawHorizontalLine( int aX, int aY, int aWidth, TPixel aValue ) NOEXCEPT
+        {
+            FillRectangle( aX, aY, aWidth, 1, aValue );
+        }
+
+        inline void
+        DrawVerticalLine( int aX, int aY, int aHeight, TPixel aValue ) NOEXCEPT
+        {
+            FillRectangle( aX, aY, 1, aHeight, aValue );
+        }
+
+        void
+        FillRectangle( int aX, int aY, int aWidth, int aHeight, TPixel aValue ) NOEXCEPT
+        {
+            if ( !ClipRectangle( aX, aY, aWidth, aHeight ) )
+            {
+                return;
+            }
+
+            const auto beginPage = PageOf( aY );
+            const auto lastPage = PageOf( aY + aHeight - 1 );
+            for ( auto page = beginPage; page <= lastPage; ++page )
+            {
+                const auto mask = PageBitMask( page, aY, aY + aHeight - 1 );
+                auto* row = DisplayBuffer( ) + page * CRenderAreaNavigation::iColumns + aX;
+                if ( mask == KFullPageMask )
+                {
+                    std::memset( row, aValue.iPixelValue ? 0xFF : 0x00, aWidth );
+                }
+                else if ( aValue.iPixelValue )
+                {
+                    for ( int i = 0; i < aWidth; ++i )
+                    {
+                        row[ i ] |= mask;
+                    }
+                }
+                else
+                {
+                    for ( int i = 0; i < aWidth; ++i )
+                    {
+                        row[ i ] &= static_cast< TPage >( ~mask );
+                    }
+                }
+            }
+
+            MarkDirty( static_cast< std::uint8_t >( aX ),
+                       static_cast< std::uint8_t >( aX + aWidth - 1 ), beginPage, lastPage );
+        }
+
+        /**
+         * @brief Draws the row-major packed 1bpp bitmap (the MSB of the first byte is the left
+         * top pixel) at the given position. Both set and cleared bitmap pixels are copied.
+         *
+         * @param aX The render area column of the bitmap left edge
+         * @param aY The render area row of the bitmap top edge
+         * @param aWidth The bitmap width in pixels
+         * @param aHeight The bitmap height in pixels
+         * @param aBitmap The bitmap data
+         * @param aStride The distance between the bitmap rows in bytes
+         */
+        inline void
+        DrawBitmap( int aX,
+                    int aY,
+                    int aWidth,
+                    int aHeight,
+                    const std::uint8_t* aBitmap,
+                    size_t aStride ) NOEXCEPT
+        {
+            assert( aStride * 8u >= static_cast< size_t >( aWidth ) );
+            DrawBitmapRegion( aX, aY, aBitmap, aStride, 0, 0, aWidth, aHeight );
+        }
+
+        /**
+         * @brief Draws a rectangle of the row-major packed 1bpp bitmap at the given position.
+         * The byte aligned bitmap columns are converted 8x8 block-wise by CBitmapConversion.
+         *
+         * @param aX The render area column of the rectangle left edge
+         * @param aY The render area row of the rectangle top edge
+         * @param aBitmap The bitmap data
+         * @param aStride The distance between the bitmap rows in bytes
+         * @param aSourceX The bitmap column of the rectangle left edge
+         * @param aSourceY The bitmap row of the rectangle top edge
+         * @param aWidth The rectangle width in pixels
+         * @param aHeight The rectangle height in pixels
+         */
+        void
+        DrawBitmapRegion( int aX,
+                          int aY,
+                          const std::uint8_t* aBitmap,
+                          size_t aStride,
+                          int aSourceX,
+                          int aSourceY,
+                          int aWidth,
+                          int aHeight ) NOEXCEPT
+        {
+            assert( aBitmap != nullptr );
+            assert( aSourceX >= 0 );
+            assert( aSourceY >= 0 );
+
+            // The bitmap origin in the render area coordinates
+            const int bitmapX = aX - aSourceX;
+            const int bitmapY = aY - aSourceY;
+            if ( !ClipRectangle( aX, aY, aWidth, aHeight ) )
+            {
+                return;
+            }
+
+            const int endX = aX + aWidth;
+            const auto beginPage = PageOf( aY );
+            const auto lastPage = PageOf( aY + aHeight - 1 );
+            for ( auto page = beginPage; page <= lastPage; ++page )
+            {
+                const int pageY = page * TSsd1306Hal::KPixelsPerPage;
+                const int beginBit = std::max( aY - pageY, 0 );
+                const int lastBit
+                    = std::min( aY + aHeight - 1 - pageY, TSsd1306Hal::KPixelsPerPage - 1 );
+                const auto mask = PageBitMask( page, aY, aY + aHeight - 1 );
+                auto* row = DisplayBuffer( ) + page * CRenderAreaNavigation::iColumns;
+
+                // Scalar head up to the first byte aligned bitmap column
+                int x = aX;
+                for ( ; x < endX && ( ( x - bitmapX ) & 7 ) != 0; ++x )
+                {
+                    const int bitmapColumn = x - bitmapX;
+                    const auto* bitmapByte = aBitmap + ( pageY + beginBit - bitmapY ) * aStride
+                                             + ( bitmapColumn >> 3 );
+                    const int shift = 7 - ( bitmapColumn & 7 );
+
+                    TPage value = 0;
+                    for ( int bit = beginBit; bit <= lastBit; ++bit, bitmapByte += aStride )
+                    {
+                        value |= static_cast< TPage >( ( ( *bitmapByte >> shift ) & 1u ) << bit );
+                    }
+                    row[ x ] = static_cast< TPage >( ( row[ x ] & ~mask ) | value );
+                }
+
+                if ( x == endX )
+                {
+                    continue;
+                }
+
+                const size_t byteOffset = static_cast< size_t >( x - bitmapX ) >> 3;
+                const std::uint8_t* rows[ CBitmapConversion::KRowsPerPage ];
+                for ( int bit = 0; bit < TSsd1306Hal::KPixelsPerPage; ++bit )
+                {
+                    rows[ bit ] = bit < beginBit || bit > lastBit
+                                      ? KZeroRow
+                                      : aBitmap + ( pageY + bit - bitmapY ) * aStride + byteOffset;
+                }
+
+                if ( mask == KFullPageMask )
+                {
+                    CBitmapConversion::ConvertPage( rows, endX - x, row + x );
+                    continue;
+                }
+
+                TPage converted[ TSsd1306Hal::KMaxColumns ];
+                CBitmapConversion::ConvertPage( rows, endX - x, converted );
+                for ( int i = 0; x < endX; ++x, ++i )
+                {
+                    row[ x ] = static_cast< TPage >( ( row[ x ] & ~mask ) | converted[ i ] );
+                }
+            }
+
+            MarkDirty( static_cast< std::uint8_t >( aX ),
+                       static_cast< std::uint8_t >( aX + aWidth - 1 ), beginPage, lastPage );
+        }
+
+        /**
+         * @brief Draws the bitmap already in the page-major layout (one byte per column, the LSB
+         * is the top pixel) at the given position. At a page aligned position the bitmap rows are
+         * copied as they are, otherwise every area page combines the shifted bytes of two bitmap
+         * pages.
+         *
+         * @param aX The render area column of the bitmap left edge
+         * @param aY The render area row of the bitmap top edge
+         * @param aWidth The bitmap width in columns
+         * @param aHeight The bitmap height in pixels
+         * @param aBitmap The bitmap pages, ( aHeight + 7 ) / 8 rows of column bytes
+         * @param aStride The distance between the bitmap page rows in bytes
+         * @param aTransparent Draw only the set bitmap pixels, otherwise the cleared ones are
+         * drawn as well
+         */
+        void
+        DrawPageBitmap( int aX,
+                        int aY,
+                        int aWidth,
+                        int aHeight,
+                        const TPage* aBitmap,
+                        size_t aStride,
+                        bool aTransparent = false ) NOEXCEPT
+        {
+            assert( aBitmap != nullptr );
+            assert( aStride >= static_cast< size_t >( aWidth ) );
+
+            const int bitmapX = aX;
+            const int bitmapY = aY;
+            const int bitmapPages = ( aHeight + TSsd1306Hal::KPixelsPerPage - 1 )
+                                    / TSsd1306Hal::KPixelsPerPage;
+            if ( !ClipRectangle( aX, aY, aWidth, aHeight ) )
+            {
+                return;
+            }
+
+            const auto beginPage = PageOf( aY );
+            const auto lastPage = PageOf( aY + aHeight - 1 );
+            for ( auto page = beginPage; page <= lastPage; ++page )
+            {
+                const auto mask = PageBitMask( page, aY, aY + aHeight - 1 );
+                auto* row = DisplayBuffer( ) + page * CRenderAreaNavigation::iColumns + aX;
+
+                // The bitmap row at the top of the area page, negative above the bitmap
+                const int offset = page * TSsd1306Hal::KPixelsPerPage - bitmapY;
+                const int bitmapPage = offset >= 0 ? offset / TSsd1306Hal::KPixelsPerPage : -1;
+                const int shift = offset >= 0 ? offset % TSsd1306Hal::KPixelsPerPage
+                                              : offset + TSsd1306Hal::KPixelsPerPage;
+                const TPage* upper
+                    = bitmapPage >= 0 ? aBitmap + bitmapPage * aStride + ( aX - bitmapX )
+                                      : nullptr;
+                const TPage* lower = bitmapPage + 1 < bitmapPages
+                                         ? aBitmap + ( bitmapPage + 1 ) * aStride + ( aX - bitmapX )
+                                         : nullptr;
+
+                if ( shift == 0 && mask == KFullPageMask && !aTransparent )
+                {
+                    std::memcpy( row, upper, aWidth );
+                    continue;
+                }
+
+                for ( int i = 0; i < aWidth; ++i )
+                {
+                    TPage value = 0;
+                    if ( upper != nullptr )
+                    {
+                        value = static_cast< TPage >( upper[ i ] >> shift );
+                    }
+                    if ( lower != nullptr && shift != 0 )
+                    {
+                        value |= static_cast< TPage >(
+                            lower[ i ] << ( TSsd1306Hal::KPixelsPerPage - shift ) );
+                    }
+                    value &= mask;
+                    row[ i ] = aTransparent ? static_cast< TPage >( row[ i ] | value )
+                                            : static_cast< TPage >( ( row[ i ] & ~mask ) | value );
+                }
+            }
+
+            MarkDirty( static_cast< std::uint8_t >( aX ),
+                       static_cast< std::uint8_t >( aX + aWidth - 1 ), beginPage, lastPage );
+        }
+
+        /**
+         * @brief Checks whether the render area has changes that haven't been rendered yet.
+         * A newly created render area is entirely dirty.
+         */
+        constexpr bool
+        IsDirty( ) const NOEXCEPT
+        {
+            return iDirtyBeginColumn <= iDirtyLastColumn;
+        }
+
+        /**
+         * @brief Extends the dirty region with the given rectangle. The column and page indexes
+         * are relative to the render area.
+         */
+        void
+        MarkDirty( std::uint8_t aBeginColumn,
+                   std::uint8_t aLastColumn,
+                   std::uint8_t aBeginPage,
+                   std::uint8_t aLastPage ) NOEXCEPT
+        {
+            ExtendDirtyRegion( aBeginColumn, aLastColumn, aBeginPage, aLastPage );
+        }
+
+        inline void
+        MarkDirty( std::uint8_t aColumn, std::uint8_t aPage ) NOEXCEPT
+        {
+            MarkDirty( aColumn, aColumn, aPage, aPage );
+        }
+
+        inline void
+        MarkAllDirty( ) NOEXCEPT
+        {
+            iDirtyBeginColumn = 0;
+            iDirtyLastColumn = CRenderAreaNavigation::iColumns - 1;
+            iDirtyBeginPage = 0;
+            iDirtyLastPage = CRenderAreaNavigation::iRows - 1;
         }
 
         constexpr size_t
@@ -228,48 +608,274 @@ public:
         const std::uint8_t*
         DisplayBuffer( ) const NOEXCEPT
         {
-            return iBuffer.get( ) + GetControlCommandLength( );
+            return iBuffer;
         }
 
-    private:
-        friend class CSsd1306;
+        static constexpr size_t
+        DisplayBufferSize( std::uint8_t aBeginColumn,
+                           std::uint8_t aLastColumn,
+                           std::uint8_t aBeginPage,
+                           std::uint8_t aLastPage )
+        {
+            return CRenderAreaNavigation::Columns( aBeginColumn, aLastColumn )
+                   * CRenderAreaNavigation::Rows( aBeginPage, aLastPage );
+        }
 
-        CRenderArea( std::uint8_t aBeginColumn,
-                     std::uint8_t aLastColumn,
-                     std::uint8_t aBeginPage,
-                     std::uint8_t aLastPage )
+    protected:
+        static constexpr TPage KFullPageMask = 0xFF;
+        // Stands for the bitmap rows outside of the drawn rectangle
+        static constexpr std::uint8_t KZeroRow[ TSsd1306Hal::KMaxColumns / 8 + 1 ] = { };
+
+        static constexpr std::uint8_t
+        PageOf( int aY )
+        {
+            return static_cast< std::uint8_t >( static_cast< unsigned >( aY )
+                                                / TSsd1306Hal::KPixelsPerPage );
+        }
+
+        /**
+         * @brief Mask of the page bits covered by the rows [aBeginY, aLastY].
+         */
+        static constexpr TPage
+        PageBitMask( std::uint8_t aPage, int aBeginY, int aLastY )
+        {
+            const int pageY = aPage * TSsd1306Hal::KPixelsPerPage;
+            const int beginBit = aBeginY > pageY ? aBeginY - pageY : 0;
+            const int lastBit = aLastY - pageY < TSsd1306Hal::KPixelsPerPage - 1
+                                    ? aLastY - pageY
+                                    : TSsd1306Hal::KPixelsPerPage - 1;
+            return static_cast< TPage >( ( KFullPageMask << beginBit )
+                                         & ( KFullPageMask >> ( 7 - lastBit ) ) );
+        }
+
+        /**
+         * @brief Clips the rectangle to the render area.
+         *
+         * @return true if some part of the rectangle is inside the render area
+         */
+        bool
+        ClipRectangle( int& aX, int& aY, int& aWidth, int& aHeight ) const NOEXCEPT
+        {
+            const int right = std::min( aX + aWidth, CRenderAreaNavigation::GetPixelWidth( ) );
+            const int bottom = std::min( aY + aHeight, CRenderAreaNavigation::GetPixelHeight( ) );
+            aX = std::max( aX, 0 );
+            aY = std::max( aY, 0 );
+            aWidth = right - aX;
+            aHeight = bottom - aY;
+            return aWidth > 0 && aHeight > 0;
+        }
+
+        CRenderAreaBase( CRenderAreaBase&& ) = default;
+
+        /**
+         * @brief Construct a new render area over the given storage. The storage must be at
+         * least DisplayBufferSize() bytes long and outlive the render area.
+         *
+         * @param aHeadroom The byte preceding the storage belongs to the area too, so the
+         * renders may borrow it for the data control byte
+         */
+        CRenderAreaBase( std::uint8_t aBeginColumn,
+                         std::uint8_t aLastColumn,
+                         std::uint8_t aBeginPage,
+                         std::uint8_t aLastPage,
+                         TPage* aBuffer,
+                         bool aHeadroom = false )
             : CRenderAreaNavigation{ aBeginColumn, aLastColumn, aBeginPage, aLastPage }
-            , iBuffer{ std::make_unique< TPage[] >( RawBufferSize( ) ) }
+            , iBuffer{ aBuffer }
+            , iHeadroom{ aHeadroom }
         {
-            iBuffer[ 0 ] = TSsd1306Hal::KCmdSetRamBuffer;
+            MarkAllDirty( );
         }
 
-        static inline constexpr size_t
-        GetControlCommandLength( )
+        void
+        AttachBuffer( TPage* aBuffer, bool aHeadroom ) NOEXCEPT
         {
-            return sizeof( TSsd1306Hal::KCmdSetRamBuffer );
+            assert( aBuffer != nullptr );
+            iBuffer = aBuffer;
+            iHeadroom = aHeadroom;
         }
 
+    private:
+        friend class CSsd1306;
+
         std::uint8_t*
         DisplayBuffer( ) NOEXCEPT
         {
-            return iBuffer.get( ) + GetControlCommandLength( );
+            return iBuffer;
         }
-        inline std::uint8_t*
-        RawBuffer( ) const NOEXCEPT
+
+        inline bool
+        IsAllDirty( ) const NOEXCEPT
         {
-            return iBuffer.get( );
+            return iDirtyBeginColumn == 0 && iDirtyLastColumn == CRenderAreaNavigation::iColumns - 1
+                   && iDirtyBeginPage == 0 && iDirtyLastPage == CRenderAreaNavigation::iRows - 1;
         }
 
-        inline size_t
-        RawBufferSize( ) const
+        void
+        ExtendDirtyRegion( std::uint8_t aBeginColumn,
+                           std::uint8_t aLastColumn,
+                           std::uint8_t aBeginPage,
+                           std::uint8_t aLastPage ) const NOEXCEPT
+        {
+            assert( aBeginColumn <= aLastColumn );
+            assert( aLastColumn < CRenderAreaNavigation::iColumns );
+            assert( aBeginPage <= aLastPage );
+            assert( aLastPage < CRenderAreaNavigation::iRows );
+
+            iDirtyBeginColumn = std::min( iDirtyBeginColumn, aBeginColumn );
+            iDirtyLastColumn = std::max( iDirtyLastColumn, aLastColumn );
+            iDirtyBeginPage = std::min( iDirtyBeginPage, aBeginPage );
+            iDirtyLastPage = std::max( iDirtyLastPage, aLastPage );
+        }
+
+        inline void
+        MarkClean( ) const NOEXCEPT
+        {
+            iDirtyBeginColumn = std::numeric_limits< std::uint8_t >::max( );
+            iDirtyLastColumn = 0;
+            iDirtyBeginPage = std::numeric_limits< std::uint8_t >::max( );
+            iDirtyLastPage = 0;
+        }
+
+        TPage* iBuffer;
+        bool iHeadroom;
+
+        // Dirty region bounds relative to the render area. The region is empty when the begin
+        // column is greater than the last one. Rendering a const area cleans it up.
+        mutable std::uint8_t iDirtyBeginColumn = std::numeric_limits< std::uint8_t >::max( );
+        mutable std::uint8_t iDirtyLastColumn = 0;
+        mutable std::uint8_t iDirtyBeginPage = std::numeric_limits< std::uint8_t >::max( );
+        mutable std::uint8_t iDirtyLastPage = 0;
+    };
+
+    // The alignment of the render area buffers allocated by the driver, suits the word and
+    // the SIMD drawing
+    static constexpr size_t KDefaultBufferAlignment = 16;
+    // The aligned headroom block preceding the buffers allocated by the driver, for the data
+    // control byte only the I2C transfers need
+    static constexpr size_t KHeadroomBlocks = TSsd1306Hal::KDataHeaderSize != 0 ? 1 : 0;
+
+    /**
+     * @brief The render area with the buffer allocated on the heap. Created by
+     * CreateRenderArea().
+     */
+    class CRenderArea : public CRenderAreaBase
+    {
+    public:
+        CRenderArea( CRenderArea&& ) = default;
+        ~CRenderArea( ) override = default;
+
+    private:
+        friend class CSsd1306;
+
+        CRenderArea( std::uint8_t aBeginColumn,
+                     std::uint8_t aLastColumn,
+                     std::uint8_t aBeginPage,
+                     std::uint8_t aLastPage )
+            : CRenderAreaBase{ aBeginColumn, aLastColumn, aBeginPage, aLastPage, nullptr }
+            , iStorage{ std::make_unique< TBlock[] >(
+                  KHeadroomBlocks
+                  + ( CRenderAreaBase::DisplayBufferSize( aBeginColumn, aLastColumn, aBeginPage,
+                                                          aLastPage )
+                      + KDefaultBufferAlignment - 1 )
+                        / KDefaultBufferAlignment ) }
+        {
+            // The first block is the headroom, if the transport needs one
+            CRenderAreaBase::AttachBuffer( reinterpret_cast< TPage* >( iStorage.get( ) )
+                                               + KHeadroomBlocks * KDefaultBufferAlignment,
+                                           KHeadroomBlocks != 0 );
+        }
+
+        struct alignas( KDefaultBufferAlignment ) TBlock
+        {
+            TPage iPages[ KDefaultBufferAlignment ];
+        };
+
+        std::unique_ptr< TBlock[] > iStorage;
+    };
+
+    /**
+     * @brief The render area with the compile-time known position and size. The buffer is
+     * kept inline, so the area doesn't touch the heap and can be placed statically or on the
+     * stack.
+     *
+     * @tparam taBeginColumn The first display column covered by the area
+     * @tparam taLastColumn The last display column covered by the area
+     * @tparam taBeginPage The first display page covered by the area
+     * @tparam taLastPage The last display page covered by the area
+     * @tparam taAlignment The buffer alignment, the headroom preceding the buffer takes as much
+     */
+    template < std::uint8_t taBeginColumn = 0,
+               std::uint8_t taLastColumn = TSsd1306Hal::KMaxColumns - 1,
+               std::uint8_t taBeginPage = 0,
+               std::uint8_t taLastPage = TSsd1306Hal::KMaxPages - 1,
+               size_t taAlignment = KDefaultBufferAlignment >
+    class CStaticRenderArea : public CRenderAreaBase
+    {
+        static_assert( taBeginColumn <= taLastColumn, "Invalid column range" );
+        static_assert( taLastColumn < TSsd1306Hal::KMaxColumns, "Column is out of the display" );
+        static_assert( taBeginPage <= taLastPage, "Invalid page range" );
+        static_assert( taLastPage < TSsd1306Hal::KMaxPages, "Page is out of the display" );
+        static_assert( taAlignment != 0 && ( taAlignment & ( taAlignment - 1 ) ) == 0,
+                       "The alignment must be a power of two" );
+
+    public:
+        CStaticRenderArea( ) NOEXCEPT
+            : CRenderAreaBase{ taBeginColumn, taLastColumn, taBeginPage, taLastPage, nullptr }
+            , iStorage{ }
         {
-            return GetControlCommandLength( ) + GetDisplayBufferSize( );
+            CRenderAreaBase::AttachBuffer( iStorage + KHeadroom, KHeadroom != 0 );
         }
 
-        std::unique_ptr< TPage[] > iBuffer;
+        // The base class points into the inline storage, so the area can't be moved or copied
+        CStaticRenderArea( const CStaticRenderArea& ) = delete;
+        CStaticRenderArea& operator=( const CStaticRenderArea& ) = delete;
+
+    private:
+        static constexpr size_t KHeadroom = KHeadroomBlocks * taAlignment;
+
+        alignas( taAlignment ) TPage iStorage[ KHeadroom
+                                               + CRenderAreaBase::DisplayBufferSize(
+                                                   taBeginColumn, taLastColumn, taBeginPage,
+                                                   taLastPage ) ];
+    };
+
+    /**
+     * @brief The render area over a buffer owned by the application, e.g. a frame buffer
+     * shared with other code. The buffer is sent without being copied on the buses gathering
+     * the transactions, or when the area may borrow the byte preceding the buffer. The renders
+     * never write the buffer, nor the byte preceding it unless the area has the headroom.
+     */
+    class CExternalRenderArea : public CRenderAreaBase
+    {
+    public:
+        /**
+         * @brief Construct a new render area over the buffer
+         *
+         * @param aBuffer The page-major buffer of DisplayBufferSize() bytes at least, must
+         * outlive the render area
+         * @param aHeadroom The byte preceding the buffer may be borrowed by the renders, with
+         * no one else accessing it meanwhile
+         */
+        CExternalRenderArea( std::uint8_t aBeginColumn,
+                             std::uint8_t aLastColumn,
+                             std::uint8_t aBeginPage,
+                             std::uint8_t aLastPage,
+                             TPage* aBuffer,
+                             bool aHeadroom = false ) NOEXCEPT
+            : CRenderAreaBase{ aBeginColumn, aLastColumn, aBeginPage, aLastPage, aBuffer,
+                               aHeadroom }
+        {
+            assert( aBeginColumn <= aLastColumn );
+            assert( aLastColumn < TSsd1306Hal::KMaxColumns );
+            assert( aBeginPage <= aLastPage );
+            assert( aLastPage < TSsd1306Hal::KMaxPages );
+            assert( aBuffer != nullptr );
+        }
     };
 
+    using CFullScreenRenderArea = CStaticRenderArea<>;
+
     CRenderArea
     CreateRenderArea( std::uint8_t aBeginColumn = 0,
                       std::uint8_t aLastColumn = TSsd1306Hal::KMaxColumns - 1,
@@ -284,21 +890,294 @@ public:
         return CRenderArea( aBeginColumn, aLastColumn, aBeginPage, aLastPage );
     }
 
-    void
-    Render( const CRenderArea& aRenderArea )
+    // The maximum data bytes of one SendRegionChunk() transaction, a page row
+    static constexpr size_t KMaxChunkSize = TSsd1306Hal::KMaxColumns;
+
+    /**
+     * @brief Rectangle of a render area in the area relative column and page indexes.
+     */
+    struct TRegion
+    {
+        std::uint8_t iBeginColumn;
+        std::uint8_t iLastColumn;
+        std::uint8_t iBeginPage;
+        std::uint8_t iLastPage;
+    };
+
+    /**
+     * @brief Takes over the dirty region of the render area for the renderers sending it on
+     * their own. The render area becomes clean.
+     *
+     * @return true if the area had changes, false otherwise
+     */
+    bool
+    TakeDirtyRegion( const CRenderAreaBase& aRenderArea, TRegion& aRegion ) const NOEXCEPT
+    {
+        if ( !aRenderArea.IsDirty( ) )
+        {
+            return false;
+        }
+
+        aRegion = TRegion{ aRenderArea.iDirtyBeginColumn, aRenderArea.iDirtyLastColumn,
+                           aRenderArea.iDirtyBeginPage, aRenderArea.iDirtyLastPage };
+        aRenderArea.MarkClean( );
+        return true;
+    }
+
+    /**
+     * @brief Gives the region taken by TakeDirtyRegion() back to the render area, e.g. when
+     * sending it has failed.
+     */
+    inline void
+    RestoreDirtyRegion( const CRenderAreaBase& aRenderArea, const TRegion& aRegion ) const NOEXCEPT
+    {
+        aRenderArea.ExtendDirtyRegion( aRegion.iBeginColumn, aRegion.iLastColumn,
+                                       aRegion.iBeginPage, aRegion.iLastPage );
+    }
+
+    /**
+     * @brief The number of the display buffer bytes in the region.
+     */
+    static constexpr size_t
+    RegionSize( const TRegion& aRegion ) NOEXCEPT
+    {
+        return ( aRegion.iLastColumn - aRegion.iBeginColumn + 1u )
+               * ( aRegion.iLastPage - aRegion.iBeginPage + 1u );
+    }
+
+    /**
+     * @brief Sets the RAM address windows to the region of the render area in one command
+     * stream transaction, the first step of sending the region in chunks.
+     */
+    TErrorCode
+    SendRegionWindow( const CRenderAreaBase& aRenderArea, const TRegion& aRegion ) NOEXCEPT
+    {
+        typename TSsd1306Hal::CCommandStream stream{ iSsd1306Hal };
+        iSsd1306Hal.SetColumnAddress( aRenderArea.iBeginColumn + aRegion.iBeginColumn,
+                                      aRenderArea.iBeginColumn + aRegion.iLastColumn );
+        iSsd1306Hal.SetPageAddress( aRenderArea.iBeginPage + aRegion.iBeginPage,
+                                    aRenderArea.iBeginPage + aRegion.iLastPage );
+        return stream.Flush( );
+    }
+
+    /**
+     * @brief Sends the next chunk of the region data in one data transaction. The region rows
+     * are packed into a stack buffer, the display advances its RAM pointer within the windows
+     * set by SendRegionWindow().
+     *
+     * @param aSentBytes The region bytes sent so far, advanced on success
+     * @param aChunkSize The maximum number of the data bytes to send, up to KMaxChunkSize
+     * @param aNoStop Keep the bus after the transaction unless it is the last one of the region
+     */
+    TErrorCode
+    SendRegionChunk( const CRenderAreaBase& aRenderArea,
+                     const TRegion& aRegion,
+                     size_t& aSentBytes,
+                     size_t aChunkSize,
+                     bool aNoStop = false ) NOEXCEPT
+    {
+        assert( aChunkSize != 0 && aChunkSize <= KMaxChunkSize );
+
+        const size_t regionSize = RegionSize( aRegion );
+        const size_t regionWidth = aRegion.iLastColumn - aRegion.iBeginColumn + 1u;
+        const size_t chunkSize = std::min( aChunkSize, regionSize - aSentBytes );
+
+        // The headroom byte taken by the data control byte and the chunk data
+        std::uint8_t buffer[ TSsd1306Hal::KDataHeaderSize + KMaxChunkSize ];
+        auto* const chunk = buffer + TSsd1306Hal::KDataHeaderSize;
+
+        size_t offset = aSentBytes;
+        size_t copied = 0;
+        while ( copied < chunkSize )
+        {
+            const size_t row = offset / regionWidth;
+            const size_t column = offset % regionWidth;
+            const size_t length = std::min( regionWidth - column, chunkSize - copied );
+            const auto* source = aRenderArea.DisplayBuffer( )
+                                 + ( aRegion.iBeginPage + row ) * aRenderArea.Columns( )
+                                 + aRegion.iBeginColumn + column;
+            std::memcpy( chunk + copied, source, length );
+            copied += length;
+            offset += length;
+        }
+
+        RETURN_ON_ERROR(
+            iSsd1306Hal.SendRamDataInPlace( chunk, chunkSize, aNoStop && offset != regionSize ) );
+        aSentBytes = offset;
+        return AbstractPlatform::KOk;
+    }
+
+    /**
+     * @brief Sends the dirty region of the render area to the display. The column and page
+     * address windows are narrowed to the bounding box of the changes made since the previous
+     * render, so only the changed part of the area goes through the bus.
+     *
+     * @param aRenderArea The render area to be rendered
+     * @param aSkippedBytes Receives the number of the display buffer bytes skipped as unchanged
+     * @return TErrorCode KOk on success, otherwise the first bus error. The render area stays
+     * dirty on failure, so the next render sends the region again.
+     */
+    TErrorCode
+    Render( const CRenderAreaBase& aRenderArea, size_t* aSkippedBytes = nullptr )
+    {
+        using namespace AbstractPlatform;
+        SSD1306_INSTRUMENT_SCOPE( iSsd1306Hal.Instrumentation( ), Render );
+
+        assert( aRenderArea.DisplayBuffer( ) != nullptr );
+
+        const auto displayBufferSize = aRenderArea.GetDisplayBufferSize( );
+        size_t skippedBytes = displayBufferSize;
+        if ( aRenderArea.IsAllDirty( ) )
+        {
+            typename TSsd1306Hal::CCommandStream stream{ iSsd1306Hal };
+            iSsd1306Hal.SetColumnAddress( aRenderArea.iBeginColumn, aRenderArea.iLastColumn );
+            iSsd1306Hal.SetPageAddress( aRenderArea.iBeginPage, aRenderArea.iLastPage );
+
+            RETURN_ON_ERROR( SendAreaData( aRenderArea, 0, displayBufferSize ) );
+            aRenderArea.MarkClean( );
+            skippedBytes = 0;
+        }
+        else if ( aRenderArea.IsDirty( ) )
+        {
+            size_t sentBytes = 0;
+            RETURN_ON_ERROR( RenderRegion( aRenderArea, aRenderArea.iDirtyBeginColumn,
+                                           aRenderArea.iDirtyLastColumn,
+                                           aRenderArea.iDirtyBeginPage,
+                                           aRenderArea.iDirtyLastPage, &sentBytes ) );
+            aRenderArea.MarkClean( );
+            skippedBytes -= sentBytes;
+        }
+
+        if ( aSkippedBytes != nullptr )
+        {
+            *aSkippedBytes = skippedBytes;
+        }
+        return KOk;
+    }
+
+    /**
+     * @brief Sends a rectangle of the render area. The column and page indexes are relative to
+     * the render area. The rectangle spanning the whole area width is contiguous in the area
+     * buffer and is sent right from it. Otherwise the rectangle rows are packed into a stack
+     * chunk, each chunk is sent as a separate data transaction while the display keeps
+     * advancing its RAM pointer within the address windows.
+     *
+     * @param aSentBytes Receives the number of the display buffer bytes sent
+     * @return TErrorCode KOk on success, otherwise the first bus error
+     */
+    TErrorCode
+    RenderRegion( const CRenderAreaBase& aRenderArea,
+                  std::uint8_t aBeginColumn,
+                  std::uint8_t aLastColumn,
+                  std::uint8_t aBeginPage,
+                  std::uint8_t aLastPage,
+                  size_t* aSentBytes = nullptr )
     {
         using namespace AbstractPlatform;
-        const auto rawBufferSize = aRenderArea.RawBufferSize( );
-        assert( rawBufferSize != 0u );
-        assert( aRenderArea.RawBuffer( ) != nullptr );
+        assert( aBeginColumn <= aLastColumn );
+        assert( aLastColumn < aRenderArea.Columns( ) );
+        assert( aBeginPage <= aLastPage );
+        assert( aLastPage < aRenderArea.Rows( ) );
+        SSD1306_INSTRUMENT_SCOPE( iSsd1306Hal.Instrumentation( ), Render );
+
+        typename TSsd1306Hal::CCommandStream stream{ iSsd1306Hal };
+        iSsd1306Hal.SetColumnAddress( aRenderArea.iBeginColumn + aBeginColumn,
+                                      aRenderArea.iBeginColumn + aLastColumn );
+        iSsd1306Hal.SetPageAddress( aRenderArea.iBeginPage + aBeginPage,
+                                    aRenderArea.iBeginPage + aLastPage );
+
+        const size_t rowLength = aLastColumn - aBeginColumn + 1u;
+        const size_t regionSize = rowLength * ( aLastPage - aBeginPage + 1u );
+        if ( rowLength == aRenderArea.Columns( ) )
+        {
+            RETURN_ON_ERROR(
+                SendAreaData( aRenderArea, aBeginPage * aRenderArea.Columns( ), regionSize ) );
+            if ( aSentBytes != nullptr )
+            {
+                *aSentBytes = regionSize;
+            }
+            return KOk;
+        }
+
+        constexpr size_t KChunkCapacity = TSsd1306Hal::KMaxColumns;
+        // The headroom byte taken by the data control byte and the chunk data
+        std::uint8_t buffer[ TSsd1306Hal::KDataHeaderSize + KChunkCapacity ];
+        auto* const chunk = buffer + TSsd1306Hal::KDataHeaderSize;
+        size_t chunkSize = 0;
+
+        const auto* displayBuffer = aRenderArea.DisplayBuffer( );
+        for ( size_t page = aBeginPage; page <= aLastPage; ++page )
+        {
+            const auto* row = displayBuffer + page * aRenderArea.Columns( ) + aBeginColumn;
+            size_t copied = 0;
+            while ( copied < rowLength )
+            {
+                const auto length = std::min( rowLength - copied, KChunkCapacity - chunkSize );
+                std::memcpy( chunk + chunkSize, row + copied, length );
+                chunkSize += length;
+                copied += length;
+                if ( chunkSize == KChunkCapacity )
+                {
+                    RETURN_ON_ERROR( iSsd1306Hal.SendRamDataInPlace( chunk, KChunkCapacity ) );
+                    chunkSize = 0;
+                }
+            }
+        }
+        if ( chunkSize != 0 )
+        {
+            RETURN_ON_ERROR( iSsd1306Hal.SendRamDataInPlace( chunk, chunkSize ) );
+        }
+
+        if ( aSentBytes != nullptr )
+        {
+            *aSentBytes = regionSize;
+        }
+        return KOk;
+    }
 
-        iSsd1306Hal.SetColumnAddress( aRenderArea.iBeginColumn, aRenderArea.iLastColumn );
-        iSsd1306Hal.SetPageAddress( aRenderArea.iBeginPage, aRenderArea.iLastPage );
+    /**
+     * @brief Sends a page-major image to the display without copying it on the buses gathering
+     * the transactions, e.g. an image asset kept in the flash memory. The column and page
+     * indexes are the display ones.
+     *
+     * @param aPages The image of ( aLastColumn - aBeginColumn + 1 ) columns by
+     * ( aLastPage - aBeginPage + 1 ) pages
+     */
+    TErrorCode
+    RenderImage( const TPage* aPages,
+                 std::uint8_t aBeginColumn,
+                 std::uint8_t aLastColumn,
+                 std::uint8_t aBeginPage,
+                 std::uint8_t aLastPage )
+    {
+        assert( aPages != nullptr );
+        assert( aBeginColumn <= aLastColumn );
+        assert( aLastColumn < TSsd1306Hal::KMaxColumns );
+        assert( aBeginPage <= aLastPage );
+        assert( aLastPage < TSsd1306Hal::KMaxPages );
+        SSD1306_INSTRUMENT_SCOPE( iSsd1306Hal.Instrumentation( ), Render );
 
-        iSsd1306Hal.SendRawBuffer( aRenderArea.RawBuffer( ), rawBufferSize );
+        typename TSsd1306Hal::CCommandStream stream{ iSsd1306Hal };
+        iSsd1306Hal.SetColumnAddress( aBeginColumn, aLastColumn );
+        iSsd1306Hal.SetPageAddress( aBeginPage, aLastPage );
+        return iSsd1306Hal.SendRamData( aPages, ( aLastColumn - aBeginColumn + 1u )
+                                                    * ( aLastPage - aBeginPage + 1u ) );
     }
 
 private:
+    /**
+     * @brief Sends the contiguous part of the area buffer. Only the part starting the buffer of
+     * the area having the headroom goes in place, the bytes preceding the other parts are the
+     * area data, so they are never borrowed.
+     */
+    TErrorCode
+    SendAreaData( const CRenderAreaBase& aRenderArea, size_t aOffset, size_t aSize )
+    {
+        auto* data = aRenderArea.iBuffer + aOffset;
+        return aOffset == 0 && aRenderArea.iHeadroom ? iSsd1306Hal.SendRamDataInPlace( data, aSize )
+                                                     : iSsd1306Hal.SendRamData( data, aSize );
+    }
+
     TSsd1306Hal iSsd1306Hal;
 };
 }  // namespace Ssd1306
@@ -0,0 +1,251 @@
+#pragma once
+#include <AbstractPlatform/common/Platform.hpp>
+#include <AbstractPlatform/common/ErrorCode.hpp>
+#include <ExternalHardware/ssd1306/SSD1306.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <algorithm>
+
+#if defined( __cpp_impl_coroutine ) && __cpp_impl_coroutine >= 201902L
+#include <coroutine>
+#define SSD1306_ASYNC_RENDERER_COROUTINES 1
+#endif
+
+namespace ExternalHardware
+{
+namespace Ssd1306
+{
+/**
+ * @brief Non-blocking renderer. The submitted render jobs are split into bounded bus
+ * transactions (the address window command stream and the data chunks of at most the configured
+ * size) and every Poll() call performs just one of them, so the caller is never stalled for a
+ * whole frame and other devices get the bus between the chunks.
+ *
+ * Poll() can be driven from the main loop or from the bus transfer-complete interrupt/DMA
+ * handler; overlapping Poll() calls are rejected, but Submit() must not preempt Poll() or vice
+ * versa. The render areas must not be changed until their jobs complete.
+ *
+ * @tparam taDisplayType The display type
+ * @tparam taQueueCapacity The maximum number of pending render jobs
+ */
+template < typename taDisplayType = Ssd1306128x32, size_t taQueueCapacity = 4 >
+class CSsd1306AsyncRenderer
+{
+public:
+    using TSsd1306 = CSsd1306< taDisplayType >;
+    using TSsd1306Hal = typename TSsd1306::TSsd1306Hal;
+    using TRenderArea = typename TSsd1306::CRenderAreaBase;
+    using TRegion = typename TSsd1306::TRegion;
+    using TErrorCode = AbstractPlatform::TErrorCode;
+    using TCompletionCallback = void ( * )( void* aContext, TErrorCode aResult );
+
+    // The data chunk and its control byte fit the 32 byte transfer limit of the most MCU stacks
+    static constexpr size_t KDefaultChunkSize = 31;
+    static constexpr size_t KMaxChunkSize = TSsd1306::KMaxChunkSize;
+
+    /**
+     * @brief Construct a new async renderer
+     *
+     * @param aDisplay The display to render to
+     * @param aChunkSize The maximum number of the data bytes sent by one Poll() call
+     * @param aHoldBus Keep the bus (no stop condition) between the data chunks of a job
+     */
+    explicit CSsd1306AsyncRenderer( TSsd1306& aDisplay,
+                                    size_t aChunkSize = KDefaultChunkSize,
+                                    bool aHoldBus = false ) NOEXCEPT
+        : iDisplay{ aDisplay }
+        , iChunkSize{ std::min( std::max< size_t >( aChunkSize, 1 ), KMaxChunkSize ) }
+        , iHoldBus{ aHoldBus }
+        , iHead{ 0 }
+        , iSize{ 0 }
+        , iPolling{ false }
+    {
+    }
+
+    /**
+     * @brief Queues the dirty region of the render area for rendering. The region is taken
+     * over at once, so the area is clean after the call.
+     *
+     * @param aRenderArea The render area to be rendered
+     * @param aCallback The function called from Poll() when the job completes
+     * @param aContext The value passed to the callback
+     * @return TErrorCode KOk if the job is queued or there is nothing to render (the callback is
+     * called at once in that case), KGenericError if the queue is full
+     */
+    TErrorCode
+    Submit( const TRenderArea& aRenderArea,
+            TCompletionCallback aCallback = nullptr,
+            void* aContext = nullptr ) NOEXCEPT
+    {
+        if ( iSize == taQueueCapacity )
+        {
+            return AbstractPlatform::KGenericError;
+        }
+
+        TJob job{ &aRenderArea, TRegion{ }, aCallback, aContext, 0, false };
+        if ( !iDisplay.TakeDirtyRegion( aRenderArea, job.iRegion ) )
+        {
+            if ( aCallback != nullptr )
+            {
+                aCallback( aContext, AbstractPlatform::KOk );
+            }
+            return AbstractPlatform::KOk;
+        }
+
+        iQueue[ ( iHead + iSize ) % taQueueCapacity ] = job;
+        ++iSize;
+        return AbstractPlatform::KOk;
+    }
+
+    /**
+     * @brief Performs the next bus transaction of the current job.
+     *
+     * @return true if there is some work left, false if the renderer is idle
+     */
+    bool
+    Poll( ) NOEXCEPT
+    {
+        if ( iSize == 0 || iPolling.exchange( true ) )
+        {
+            return iSize != 0;
+        }
+
+        auto& job = iQueue[ iHead ];
+        const auto result = job.iWindowSent ? SendNextChunk( job ) : SendWindow( job );
+        const bool finished = job.iSentBytes == TSsd1306::RegionSize( job.iRegion );
+        if ( result != AbstractPlatform::KOk || finished )
+        {
+            if ( result != AbstractPlatform::KOk )
+            {
+                // The display content of the region is unknown now
+                iDisplay.RestoreDirtyRegion( *job.iRenderArea, job.iRegion );
+            }
+            const TJob completed = job;
+            iHead = ( iHead + 1 ) % taQueueCapacity;
+            --iSize;
+            iPolling.store( false );
+            if ( completed.iCallback != nullptr )
+            {
+                completed.iCallback( completed.iContext, result );
+            }
+            return iSize != 0;
+        }
+
+        iPolling.store( false );
+        return true;
+    }
+
+    inline bool
+    Idle( ) const NOEXCEPT
+    {
+        return iSize == 0;
+    }
+
+#if defined( SSD1306_ASYNC_RENDERER_COROUTINES )
+    /**
+     * @brief Awaitable render job. The awaiting coroutine is resumed from Poll() when the job
+     * completes and gets the job result.
+     */
+    class CRenderAwaiter
+    {
+    public:
+        CRenderAwaiter( CSsd1306AsyncRenderer& aRenderer, const TRenderArea& aRenderArea )
+            : iRenderer{ aRenderer }
+            , iRenderArea{ aRenderArea }
+            , iResult{ AbstractPlatform::KOk }
+            , iCompleted{ false }
+            , iSuspended{ false }
+        {
+        }
+
+        constexpr bool
+        await_ready( ) const NOEXCEPT
+        {
+            return false;
+        }
+
+        bool
+        await_suspend( std::coroutine_handle<> aHandle ) NOEXCEPT
+        {
+            iHandle = aHandle;
+            iResult = iRenderer.Submit( iRenderArea, &CRenderAwaiter::OnCompleted, this );
+            // Don't suspend if the job has been rejected or completed right away
+            iSuspended = iResult == AbstractPlatform::KOk && !iCompleted;
+            return iSuspended;
+        }
+
+        TErrorCode
+        await_resume( ) const NOEXCEPT
+        {
+            return iResult;
+        }
+
+    private:
+        static void
+        OnCompleted( void* aContext, TErrorCode aResult )
+        {
+            auto& awaiter = *static_cast< CRenderAwaiter* >( aContext );
+            awaiter.iResult = aResult;
+            awaiter.iCompleted = true;
+            if ( awaiter.iSuspended )
+            {
+                awaiter.iHandle.resume( );
+            }
+        }
+
+        CSsd1306AsyncRenderer& iRenderer;
+        const TRenderArea& iRenderArea;
+        std::coroutine_handle<> iHandle;
+        TErrorCode iResult;
+        bool iCompleted;
+        bool iSuspended;
+    };
+
+    /**
+     * @brief co_await RenderAsync( area ) suspends the coroutine until the area is rendered.
+     */
+    inline CRenderAwaiter
+    RenderAsync( const TRenderArea& aRenderArea ) NOEXCEPT
+    {
+        return CRenderAwaiter{ *this, aRenderArea };
+    }
+#endif
+
+private:
+    struct TJob
+    {
+        const TRenderArea* iRenderArea;
+        TRegion iRegion;
+        TCompletionCallback iCallback;
+        void* iContext;
+        size_t iSentBytes;
+        bool iWindowSent;
+    };
+
+    TErrorCode
+    SendWindow( TJob& aJob ) NOEXCEPT
+    {
+        RETURN_ON_ERROR( iDisplay.SendRegionWindow( *aJob.iRenderArea, aJob.iRegion ) );
+        aJob.iWindowSent = true;
+        return AbstractPlatform::KOk;
+    }
+
+    inline TErrorCode
+    SendNextChunk( TJob& aJob ) NOEXCEPT
+    {
+        return iDisplay.SendRegionChunk( *aJob.iRenderArea, aJob.iRegion, aJob.iSentBytes,
+                                         iChunkSize, iHoldBus );
+    }
+
+    TSsd1306& iDisplay;
+    const size_t iChunkSize;
+    const bool iHoldBus;
+    TJob iQueue[ taQueueCapacity ];
+    size_t iHead;
+    size_t iSize;
+    std::atomic< bool > iPolling;
+};
+}  // namespace Ssd1306
+}  // namespace ExternalHardware
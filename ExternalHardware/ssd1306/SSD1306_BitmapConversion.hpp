@@ -0,0 +1,290 @@
+#pragma once
+#include <AbstractPlatform/common/Platform.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+#if defined( __AVX2__ )
+#include <immintrin.h>
+#elif defined( __SSE2__ )
+#include <emmintrin.h>
+#elif defined( __ARM_NEON )
+#include <arm_neon.h>
+#endif
+
+namespace ExternalHardware
+{
+namespace Ssd1306
+{
+/**
+ * @brief Conversion of the row-major packed 1bpp bitmaps (the MSB of a byte is the leftmost
+ * pixel) to the SSD1306 page-major layout (one byte per column, the LSB is the top pixel of the
+ * page). The conversion is an 8x8 bit-matrix transpose of every 8 rows x 8 columns block. The
+ * vector implementation (AVX2, SSE2 or NEON) is selected at compile time, the scalar one is used
+ * as a fallback and for the block tails.
+ */
+class CBitmapConversion
+{
+public:
+    static constexpr size_t KRowsPerPage = 8;
+    static constexpr size_t KColumnsPerByte = 8;
+
+    /**
+     * @brief Transposes one 8x8 block. Bit 7 of aRowBytes[ 0 ] is the left top pixel.
+     *
+     * @param aRowBytes One byte per row packed into a word, row 0 in the least significant byte
+     * @return std::uint64_t One byte per column packed into a word, column 0 in the least
+     * significant byte, row 0 in the LSB of every column byte
+     */
+    static constexpr std::uint64_t
+    Transpose8x8( std::uint64_t aRowBytes )
+    {
+        // Row 7 ends up in the MSBs of the column bytes, row 0 in the LSBs, while column 0
+        // comes out in the most significant byte
+        return ByteSwap( TransposeBits( aRowBytes ) );
+    }
+
+    /**
+     * @brief Transposes the 8x8 bit matrix: bit j of byte i goes to bit i of byte j. Applied
+     * to 8 consecutive column bytes of a page it gives the block of the image mirrored along
+     * its main diagonal, still in the page-major layout.
+     */
+    static constexpr std::uint64_t
+    TransposeBits( std::uint64_t aBytes )
+    {
+        std::uint64_t x = aBytes;
+        std::uint64_t t = ( x ^ ( x >> 7 ) ) & 0x00AA00AA00AA00AAull;
+        x = x ^ t ^ ( t << 7 );
+        t = ( x ^ ( x >> 14 ) ) & 0x0000CCCC0000CCCCull;
+        x = x ^ t ^ ( t << 14 );
+        t = ( x ^ ( x >> 28 ) ) & 0x00000000F0F0F0F0ull;
+        return x ^ t ^ ( t << 28 );
+    }
+
+    /**
+     * @brief Converts 8 bitmap rows to one page of column bytes.
+     *
+     * @param aRows The row pointers, aRows[ 0 ] goes to the LSB of the column bytes. The rows
+     * start at the MSB of their first byte and are read for ( aColumns + 7 ) / 8 bytes.
+     * @param aColumns The number of the columns to convert
+     * @param aPage The output column bytes, aColumns bytes long
+     */
+    static void
+    ConvertPage( const std::uint8_t* const ( &aRows )[ KRowsPerPage ],
+                 size_t aColumns,
+                 std::uint8_t* aPage ) NOEXCEPT
+    {
+        size_t byteIndex = 0;
+#if defined( __AVX2__ ) || defined( __SSE2__ )
+        byteIndex = ConvertPageSse( aRows, aColumns / KColumnsPerByte, aPage );
+#elif defined( __ARM_NEON )
+        byteIndex = ConvertPageNeon( aRows, aColumns / KColumnsPerByte, aPage );
+#endif
+        for ( ; byteIndex * KColumnsPerByte < aColumns; ++byteIndex )
+        {
+            const auto columns = Transpose8x8( LoadBlock( aRows, byteIndex ) );
+            const size_t column = byteIndex * KColumnsPerByte;
+            const size_t length = aColumns - column < KColumnsPerByte ? aColumns - column
+                                                                      : KColumnsPerByte;
+            StoreColumns( columns, aPage + column, length );
+        }
+    }
+
+    /**
+     * @brief Converts a whole row-major frame to the page-major layout.
+     *
+     * @param aBitmap The row-major bitmap
+     * @param aStride The distance between the bitmap rows in bytes
+     * @param aWidth The frame width in pixels
+     * @param aHeight The frame height in pixels, the last page is padded with zero bits
+     * @param aPages The output buffer of aWidth * ( ( aHeight + 7 ) / 8 ) bytes
+     */
+    static void
+    ConvertFrame( const std::uint8_t* aBitmap,
+                  size_t aStride,
+                  size_t aWidth,
+                  size_t aHeight,
+                  std::uint8_t* aPages ) NOEXCEPT
+    {
+        static const std::uint8_t KZeroRow[ 32 ] = { };
+        for ( size_t y = 0; y < aHeight; y += KRowsPerPage, aPages += aWidth )
+        {
+            const std::uint8_t* rows[ KRowsPerPage ];
+            for ( size_t row = 0; row < KRowsPerPage; ++row )
+            {
+                rows[ row ] = y + row < aHeight ? aBitmap + ( y + row ) * aStride : KZeroRow;
+            }
+            // Rows shorter than a padding row can't be converted at once
+            if ( y + KRowsPerPage <= aHeight || aWidth <= sizeof( KZeroRow ) * KColumnsPerByte )
+            {
+                ConvertPage( rows, aWidth, aPages );
+                continue;
+            }
+            for ( size_t x = 0; x < aWidth; x += sizeof( KZeroRow ) * KColumnsPerByte )
+            {
+                const std::uint8_t* chunkRows[ KRowsPerPage ];
+                for ( size_t row = 0; row < KRowsPerPage; ++row )
+                {
+                    chunkRows[ row ]
+                        = rows[ row ] == KZeroRow ? KZeroRow : rows[ row ] + x / KColumnsPerByte;
+                }
+                const size_t length = aWidth - x < sizeof( KZeroRow ) * KColumnsPerByte
+                                          ? aWidth - x
+                                          : sizeof( KZeroRow ) * KColumnsPerByte;
+                ConvertPage( chunkRows, length, aPages + x );
+            }
+        }
+    }
+
+private:
+    static constexpr std::uint64_t
+    ByteSwap( std::uint64_t aValue )
+    {
+        return ( ( aValue & 0x00000000000000FFull ) << 56 )
+               | ( ( aValue & 0x000000000000FF00ull ) << 40 )
+               | ( ( aValue & 0x0000000000FF0000ull ) << 24 )
+               | ( ( aValue & 0x00000000FF000000ull ) << 8 )
+               | ( ( aValue & 0x000000FF00000000ull ) >> 8 )
+               | ( ( aValue & 0x0000FF0000000000ull ) >> 24 )
+               | ( ( aValue & 0x00FF000000000000ull ) >> 40 )
+               | ( ( aValue & 0xFF00000000000000ull ) >> 56 );
+    }
+
+    static inline std::uint64_t
+    LoadBlock( const std::uint8_t* const ( &aRows )[ KRowsPerPage ], size_t aByteIndex )
+    {
+        std::uint64_t result = 0;
+        for ( size_t row = 0; row < KRowsPerPage; ++row )
+        {
+            result |= static_cast< std::uint64_t >( aRows[ row ][ aByteIndex ] ) << ( row * 8 );
+        }
+        return result;
+    }
+
+    static inline void
+    StoreColumns( std::uint64_t aColumns, std::uint8_t* aPage, size_t aLength )
+    {
+        for ( size_t column = 0; column < aLength; ++column, aColumns >>= 8 )
+        {
+            aPage[ column ] = static_cast< std::uint8_t >( aColumns );
+        }
+    }
+
+#if defined( __AVX2__ ) || defined( __SSE2__ )
+    /**
+     * @brief Interleaves 8 rows x 8 bytes so every vector holds the 8 row bytes of two
+     * consecutive column bytes: aBlocks[ i ] = { rows[ 0..7 ][ 2i ], rows[ 0..7 ][ 2i + 1 ] }.
+     */
+    static inline void
+    InterleaveRows( const std::uint8_t* const ( &aRows )[ KRowsPerPage ],
+                    size_t aByteIndex,
+                    __m128i ( &aBlocks )[ 4 ] )
+    {
+        __m128i rows[ KRowsPerPage ];
+        for ( size_t row = 0; row < KRowsPerPage; ++row )
+        {
+            rows[ row ] = _mm_loadl_epi64(
+                reinterpret_cast< const __m128i* >( aRows[ row ] + aByteIndex ) );
+        }
+        const __m128i rows01 = _mm_unpacklo_epi8( rows[ 0 ], rows[ 1 ] );
+        const __m128i rows23 = _mm_unpacklo_epi8( rows[ 2 ], rows[ 3 ] );
+        const __m128i rows45 = _mm_unpacklo_epi8( rows[ 4 ], rows[ 5 ] );
+        const __m128i rows67 = _mm_unpacklo_epi8( rows[ 6 ], rows[ 7 ] );
+        const __m128i rows0123Low = _mm_unpacklo_epi16( rows01, rows23 );
+        const __m128i rows0123High = _mm_unpackhi_epi16( rows01, rows23 );
+        const __m128i rows4567Low = _mm_unpacklo_epi16( rows45, rows67 );
+        const __m128i rows4567High = _mm_unpackhi_epi16( rows45, rows67 );
+        aBlocks[ 0 ] = _mm_unpacklo_epi32( rows0123Low, rows4567Low );
+        aBlocks[ 1 ] = _mm_unpackhi_epi32( rows0123Low, rows4567Low );
+        aBlocks[ 2 ] = _mm_unpacklo_epi32( rows0123High, rows4567High );
+        aBlocks[ 3 ] = _mm_unpackhi_epi32( rows0123High, rows4567High );
+    }
+
+    /**
+     * @brief Converts the groups of 8 column bytes (64 columns) using the byte MSB extraction.
+     * Every movemask collects one column of the interleaved column bytes, then the bytes are
+     * shifted left by one to bring the next column into the MSBs.
+     *
+     * @return size_t The number of the column bytes converted
+     */
+    static size_t
+    ConvertPageSse( const std::uint8_t* const ( &aRows )[ KRowsPerPage ],
+                    size_t aColumnBytes,
+                    std::uint8_t* aPage )
+    {
+        size_t byteIndex = 0;
+        for ( ; byteIndex + 8 <= aColumnBytes; byteIndex += 8 )
+        {
+            __m128i blocks[ 4 ];
+            InterleaveRows( aRows, byteIndex, blocks );
+            auto* page = aPage + byteIndex * KColumnsPerByte;
+#if defined( __AVX2__ )
+            for ( size_t pair = 0; pair < 2; ++pair )
+            {
+                __m256i block = _mm256_set_m128i( blocks[ pair * 2 + 1 ], blocks[ pair * 2 ] );
+                auto* columnBytes = page + pair * 4 * KColumnsPerByte;
+                for ( size_t bit = 0; bit < KColumnsPerByte; ++bit )
+                {
+                    const auto mask
+                        = static_cast< std::uint32_t >( _mm256_movemask_epi8( block ) );
+                    columnBytes[ bit ] = static_cast< std::uint8_t >( mask );
+                    columnBytes[ bit + 8 ] = static_cast< std::uint8_t >( mask >> 8 );
+                    columnBytes[ bit + 16 ] = static_cast< std::uint8_t >( mask >> 16 );
+                    columnBytes[ bit + 24 ] = static_cast< std::uint8_t >( mask >> 24 );
+                    block = _mm256_add_epi8( block, block );
+                }
+            }
+#else
+            for ( size_t pair = 0; pair < 4; ++pair )
+            {
+                __m128i block = blocks[ pair ];
+                auto* columnBytes = page + pair * 2 * KColumnsPerByte;
+                for ( size_t bit = 0; bit < KColumnsPerByte; ++bit )
+                {
+                    const auto mask = static_cast< std::uint32_t >( _mm_movemask_epi8( block ) );
+                    columnBytes[ bit ] = static_cast< std::uint8_t >( mask );
+                    columnBytes[ bit + 8 ] = static_cast< std::uint8_t >( mask >> 8 );
+                    block = _mm_add_epi8( block, block );
+                }
+            }
+#endif
+        }
+        return byteIndex;
+    }
+#elif defined( __ARM_NEON )
+    /**
+     * @brief Runs the scalar bit-matrix transpose on two blocks at once.
+     *
+     * @return size_t The number of the column bytes converted
+     */
+    static size_t
+    ConvertPageNeon( const std::uint8_t* const ( &aRows )[ KRowsPerPage ],
+                     size_t aColumnBytes,
+                     std::uint8_t* aPage )
+    {
+        size_t byteIndex = 0;
+        for ( ; byteIndex + 2 <= aColumnBytes; byteIndex += 2 )
+        {
+            const std::uint64_t blocks[ 2 ]
+                = { LoadBlock( aRows, byteIndex ), LoadBlock( aRows, byteIndex + 1 ) };
+            uint64x2_t x = vld1q_u64( blocks );
+            uint64x2_t t = vandq_u64( veorq_u64( x, vshrq_n_u64( x, 7 ) ),
+                                      vdupq_n_u64( 0x00AA00AA00AA00AAull ) );
+            x = veorq_u64( veorq_u64( x, t ), vshlq_n_u64( t, 7 ) );
+            t = vandq_u64( veorq_u64( x, vshrq_n_u64( x, 14 ) ),
+                           vdupq_n_u64( 0x0000CCCC0000CCCCull ) );
+            x = veorq_u64( veorq_u64( x, t ), vshlq_n_u64( t, 14 ) );
+            t = vandq_u64( veorq_u64( x, vshrq_n_u64( x, 28 ) ),
+                           vdupq_n_u64( 0x00000000F0F0F0F0ull ) );
+            x = veorq_u64( veorq_u64( x, t ), vshlq_n_u64( t, 28 ) );
+            // Column 0 is in the most significant byte of every block
+            const uint8x16_t columns = vrev64q_u8( vreinterpretq_u8_u64( x ) );
+            vst1q_u8( aPage + byteIndex * KColumnsPerByte, columns );
+        }
+        return byteIndex;
+    }
+#endif
+};
+}  // namespace Ssd1306
+}  // namespace ExternalHardware
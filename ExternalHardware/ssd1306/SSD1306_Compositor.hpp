@@ -0,0 +1,754 @@
+#pragma once
+#include <AbstractPlatform/common/Platform.hpp>
+#include <AbstractPlatform/common/ErrorCode.hpp>
+#include <ExternalHardware/ssd1306/SSD1306.hpp>
+#include <ExternalHardware/ssd1306/SSD1306_Font.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+namespace ExternalHardware
+{
+namespace Ssd1306
+{
+/**
+ * @brief Composes the full screen image of layers stacked bottom to top, e.g. a tile map
+ * background, a few sprites and a text overlay. The screen is divided into cells of 8 columns
+ * of a page. Every layer keeps the cells it has changed, so the compositor flattens only those
+ * cells: a cell starts black and each visible layer draws over it in turn. The flattened cells
+ * are sent as a partial update list of regions: the dirty cells of a page row are joined into
+ * runs, the runs repeated by the following pages are extended down, and a clean cell between
+ * two dirty ones is sent as well, as it costs less than starting another region.
+ *
+ * @tparam taDisplayType The display type
+ * @tparam taMaxLayers The maximum number of the layers
+ */
+template < typename taDisplayType = Ssd1306128x32, size_t taMaxLayers = 4 >
+class CSsd1306Compositor
+{
+public:
+    using TSsd1306 = CSsd1306< taDisplayType >;
+    using TSsd1306Hal = typename TSsd1306::TSsd1306Hal;
+    using TRenderArea = typename TSsd1306::CRenderAreaBase;
+    using TPage = typename TSsd1306::TPage;
+    using TErrorCode = AbstractPlatform::TErrorCode;
+
+    // The cell width in columns, a cell is one page high
+    static constexpr std::uint8_t KCellWidth = 8;
+    static constexpr std::uint8_t KCellColumns
+        = ( TSsd1306Hal::KMaxColumns + KCellWidth - 1 ) / KCellWidth;
+    static constexpr std::uint8_t KCellRows = TSsd1306Hal::KMaxPages;
+
+private:
+    static_assert( KCellColumns <= 32, "A cell row must fit the row mask" );
+
+    /**
+     * @brief The set of the cells, a bit mask of the cell columns per page.
+     */
+    class CCellMap
+    {
+    public:
+        constexpr CCellMap( ) NOEXCEPT
+            : iRows{ }
+        {
+        }
+
+        inline void
+        MarkAll( ) NOEXCEPT
+        {
+            for ( auto& row : iRows )
+            {
+                row = KAllCells;
+            }
+        }
+
+        /**
+         * @brief Marks the cells touched by the rectangle, given in pixels and clipped to the
+         * screen.
+         */
+        void
+        MarkRectangle( int aX, int aY, int aWidth, int aHeight ) NOEXCEPT
+        {
+            const int right = std::min( aX + aWidth, int{ TSsd1306Hal::KMaxColumns } );
+            const int bottom = std::min( aY + aHeight, int{ TSsd1306Hal::KPixelHight } );
+            aX = std::max( aX, 0 );
+            aY = std::max( aY, 0 );
+            if ( aX >= right || aY >= bottom )
+            {
+                return;
+            }
+
+            const auto cells = CellsMask( aX / KCellWidth, ( right - 1 ) / KCellWidth );
+            const int lastPage = ( bottom - 1 ) / TSsd1306Hal::KPixelsPerPage;
+            for ( int page = aY / TSsd1306Hal::KPixelsPerPage; page <= lastPage; ++page )
+            {
+                iRows[ page ] |= cells;
+            }
+        }
+
+        inline void
+        Merge( const CCellMap& aCellMap ) NOEXCEPT
+        {
+            for ( std::uint8_t page = 0; page < KCellRows; ++page )
+            {
+                iRows[ page ] |= aCellMap.iRows[ page ];
+            }
+        }
+
+        inline void
+        Clear( ) NOEXCEPT
+        {
+            *this = CCellMap{ };
+        }
+
+        static constexpr std::uint32_t
+        CellsMask( std::uint8_t aBeginCell, std::uint8_t aLastCell )
+        {
+            return ( KAllCells >> ( KCellColumns - 1 - aLastCell ) ) & ( KAllCells << aBeginCell );
+        }
+
+        static constexpr std::uint32_t KAllCells = 0xFFFFFFFFu >> ( 32 - KCellColumns );
+
+        std::uint32_t iRows[ KCellRows ];
+    };
+
+public:
+    /**
+     * @brief A layer of the compositor. The derived layers draw their content over the cells
+     * and report the changed cells by the Invalidate() calls.
+     */
+    class CLayer
+    {
+    public:
+        virtual ~CLayer( ) = default;
+
+        inline bool
+        Visible( ) const NOEXCEPT
+        {
+            return iVisible;
+        }
+
+        void
+        SetVisible( bool aVisible ) NOEXCEPT
+        {
+            if ( aVisible != iVisible )
+            {
+                iVisible = aVisible;
+                InvalidateContent( );
+            }
+        }
+
+        /**
+         * @brief Marks the rectangle of the screen to be composed again, in pixels.
+         */
+        inline void
+        Invalidate( int aX, int aY, int aWidth, int aHeight ) NOEXCEPT
+        {
+            iDirtyCells.MarkRectangle( aX, aY, aWidth, aHeight );
+        }
+
+        inline void
+        InvalidateAll( ) NOEXCEPT
+        {
+            iDirtyCells.MarkAll( );
+        }
+
+    protected:
+        CLayer( ) NOEXCEPT
+            : iVisible{ true }
+            , iDirtyCells{ }
+        {
+            iDirtyCells.MarkAll( );
+        }
+
+        inline void
+        InvalidateCell( std::uint8_t aCellColumn, std::uint8_t aCellRow ) NOEXCEPT
+        {
+            iDirtyCells.iRows[ aCellRow ] |= 1u << aCellColumn;
+        }
+
+        /**
+         * @brief Draws the layer over the cell.
+         *
+         * @param aColumn The first screen column of the cell
+         * @param aPage The page of the cell
+         * @param aCell The cell column bytes composed by the layers below
+         * @param aColumns The cell width, less than KCellWidth at the right edge of the screen
+         */
+        virtual void
+        ComposeCell( std::uint8_t aColumn,
+                     std::uint8_t aPage,
+                     TPage* aCell,
+                     std::uint8_t aColumns ) const NOEXCEPT
+            = 0;
+
+        /**
+         * @brief Marks all the cells the layer draws over, called when the layer is shown or
+         * hidden.
+         */
+        virtual void
+        InvalidateContent( ) NOEXCEPT
+        {
+            InvalidateAll( );
+        }
+
+    private:
+        friend class CSsd1306Compositor;
+
+        bool iVisible;
+        CCellMap iDirtyCells;
+    };
+
+    /**
+     * @brief The opaque background of 8x8 tiles, one tile per cell. A tile is 8 column bytes
+     * in the page-major layout, so a cell is composed by copying its tile.
+     */
+    class CTileMapLayer : public CLayer
+    {
+    public:
+        /**
+         * @brief Construct a new tile map filled with the tile 0.
+         *
+         * @param aTiles The tile set, KCellWidth column bytes per tile, must outlive the layer
+         */
+        explicit CTileMapLayer( const TPage* aTiles ) NOEXCEPT
+            : iTiles{ aTiles }
+            , iMap{ }
+        {
+            assert( aTiles != nullptr );
+        }
+
+        /**
+         * @brief Replaces the tile set, e.g. by another frame of the animated tiles.
+         */
+        void
+        SetTiles( const TPage* aTiles ) NOEXCEPT
+        {
+            assert( aTiles != nullptr );
+            iTiles = aTiles;
+            CLayer::InvalidateAll( );
+        }
+
+        void
+        SetTile( std::uint8_t aCellColumn, std::uint8_t aCellRow, std::uint8_t aTile ) NOEXCEPT
+        {
+            assert( aCellColumn < KCellColumns );
+            assert( aCellRow < KCellRows );
+
+            auto& tile = iMap[ aCellRow ][ aCellColumn ];
+            if ( tile != aTile )
+            {
+                tile = aTile;
+                CLayer::InvalidateCell( aCellColumn, aCellRow );
+            }
+        }
+
+        inline std::uint8_t
+        Tile( std::uint8_t aCellColumn, std::uint8_t aCellRow ) const NOEXCEPT
+        {
+            assert( aCellColumn < KCellColumns );
+            assert( aCellRow < KCellRows );
+            return iMap[ aCellRow ][ aCellColumn ];
+        }
+
+        void
+        Fill( std::uint8_t aTile ) NOEXCEPT
+        {
+            std::memset( iMap, aTile, sizeof( iMap ) );
+            CLayer::InvalidateAll( );
+        }
+
+    protected:
+        void
+        ComposeCell( std::uint8_t aColumn,
+                     std::uint8_t aPage,
+                     TPage* aCell,
+                     std::uint8_t aColumns ) const NOEXCEPT override
+        {
+            const auto tile = iMap[ aPage ][ aColumn / KCellWidth ];
+            std::memcpy( aCell, iTiles + tile * size_t{ KCellWidth }, aColumns );
+        }
+
+    private:
+        const TPage* iTiles;
+        std::uint8_t iMap[ KCellRows ][ KCellColumns ];
+    };
+
+    /**
+     * @brief A sprite image, drawn through its mask at any pixel position.
+     */
+    struct TSprite
+    {
+        int iX;
+        int iY;
+        std::uint8_t iWidth;
+        std::uint8_t iHeight;
+        // The page-major image, ( iHeight + 7 ) / 8 rows of iWidth column bytes
+        const TPage* iImage;
+        // The same layout as the image, the set bits select the drawn pixels; the whole sprite
+        // box is drawn if not set
+        const TPage* iMask;
+        bool iVisible;
+    };
+
+    /**
+     * @brief The layer of the sprites, the later sprites are drawn over the earlier ones.
+     * Changing a sprite invalidates the cells of both its old and new boxes.
+     *
+     * @tparam taMaxSprites The number of the sprite slots, all of them hidden initially
+     */
+    template < size_t taMaxSprites >
+    class CSpriteLayer : public CLayer
+    {
+    public:
+        CSpriteLayer( ) NOEXCEPT
+            : iSprites{ }
+        {
+        }
+
+        void
+        SetSprite( size_t aIndex, const TSprite& aSprite ) NOEXCEPT
+        {
+            assert( aIndex < taMaxSprites );
+            assert( aSprite.iImage != nullptr );
+
+            InvalidateSprite( iSprites[ aIndex ] );
+            iSprites[ aIndex ] = aSprite;
+            InvalidateSprite( iSprites[ aIndex ] );
+        }
+
+        inline const TSprite&
+        Sprite( size_t aIndex ) const NOEXCEPT
+        {
+            assert( aIndex < taMaxSprites );
+            return iSprites[ aIndex ];
+        }
+
+        void
+        MoveSprite( size_t aIndex, int aX, int aY ) NOEXCEPT
+        {
+            assert( aIndex < taMaxSprites );
+
+            auto& sprite = iSprites[ aIndex ];
+            if ( sprite.iX != aX || sprite.iY != aY )
+            {
+                InvalidateSprite( sprite );
+                sprite.iX = aX;
+                sprite.iY = aY;
+                InvalidateSprite( sprite );
+            }
+        }
+
+        void
+        ShowSprite( size_t aIndex, bool aVisible ) NOEXCEPT
+        {
+            assert( aIndex < taMaxSprites );
+
+            auto& sprite = iSprites[ aIndex ];
+            if ( sprite.iVisible != aVisible )
+            {
+                sprite.iVisible = true;
+                InvalidateSprite( sprite );
+                sprite.iVisible = aVisible;
+            }
+        }
+
+    protected:
+        void
+        ComposeCell( std::uint8_t aColumn,
+                     std::uint8_t aPage,
+                     TPage* aCell,
+                     std::uint8_t aColumns ) const NOEXCEPT override
+        {
+            const int pageY = aPage * TSsd1306Hal::KPixelsPerPage;
+            for ( const auto& sprite : iSprites )
+            {
+                const int begin = std::max< int >( aColumn, sprite.iX );
+                const int end = std::min< int >( aColumn + aColumns, sprite.iX + sprite.iWidth );
+                if ( !sprite.iVisible || begin >= end || sprite.iY >= pageY + 8
+                     || sprite.iY + sprite.iHeight <= pageY )
+                {
+                    continue;
+                }
+
+                // The sprite rows covered by the page
+                const auto rows = RowsMask( pageY - sprite.iY, sprite.iHeight );
+                for ( int x = begin; x < end; ++x )
+                {
+                    const auto column = static_cast< size_t >( x - sprite.iX );
+                    const auto mask = static_cast< TPage >(
+                        rows
+                        & ( sprite.iMask != nullptr
+                                ? ShiftedPage( sprite.iMask, sprite, column, pageY - sprite.iY )
+                                : 0xFF ) );
+                    const auto image
+                        = ShiftedPage( sprite.iImage, sprite, column, pageY - sprite.iY );
+                    auto& cell = aCell[ x - aColumn ];
+                    cell = static_cast< TPage >( ( cell & ~mask ) | ( image & mask ) );
+                }
+            }
+        }
+
+        void
+        InvalidateContent( ) NOEXCEPT override
+        {
+            for ( const auto& sprite : iSprites )
+            {
+                InvalidateSprite( sprite );
+            }
+        }
+
+    private:
+        inline void
+        InvalidateSprite( const TSprite& aSprite ) NOEXCEPT
+        {
+            if ( aSprite.iVisible )
+            {
+                CLayer::Invalidate( aSprite.iX, aSprite.iY, aSprite.iWidth, aSprite.iHeight );
+            }
+        }
+
+        /**
+         * @brief The mask of the page bits showing the sprite rows.
+         *
+         * @param aOffset The sprite row at the top of the page, negative above the sprite
+         */
+        static constexpr TPage
+        RowsMask( int aOffset, int aHeight )
+        {
+            const int beginBit = aOffset < 0 ? -aOffset : 0;
+            const int lastBit = std::min( aHeight - 1 - aOffset, 7 );
+            return static_cast< TPage >( ( 0xFFu << beginBit ) & ( 0xFFu >> ( 7 - lastBit ) ) );
+        }
+
+        /**
+         * @brief The column byte of the sprite bitmap shifted to the page whose top is at the
+         * given sprite row; combines two bitmap pages unless the sprite is page aligned.
+         */
+        static TPage
+        ShiftedPage( const TPage* aBitmap,
+                     const TSprite& aSprite,
+                     size_t aColumn,
+                     int aOffset ) NOEXCEPT
+        {
+            const int pages = ( aSprite.iHeight + 7 ) / 8;
+            const int upperPage = aOffset >= 0 ? aOffset / 8 : -1;
+            const int shift = aOffset >= 0 ? aOffset % 8 : aOffset + 8;
+
+            unsigned value = 0;
+            if ( upperPage >= 0 && upperPage < pages )
+            {
+                value = aBitmap[ upperPage * aSprite.iWidth + aColumn ] >> shift;
+            }
+            if ( shift != 0 && upperPage + 1 < pages )
+            {
+                value |= static_cast< unsigned >(
+                             aBitmap[ ( upperPage + 1 ) * aSprite.iWidth + aColumn ] )
+                         << ( 8 - shift );
+            }
+            return static_cast< TPage >( value );
+        }
+
+        TSprite iSprites[ taMaxSprites ];
+    };
+
+    /**
+     * @brief The layer of the text labels. The labels are drawn by CTextRenderer into the
+     * layer's own page buffer as they are set; the opaque ones hide the layers below within
+     * their boxes, the transparent ones draw just the glyph pixels. The labels shouldn't
+     * overlap, as clearing a label clears its box in the layer buffer.
+     *
+     * @tparam taMaxLabels The number of the label slots
+     */
+    template < size_t taMaxLabels >
+    class CTextLayer : public CLayer
+    {
+    public:
+        CTextLayer( ) NOEXCEPT
+            : iInk{ }
+            , iInkArea{ 0, TSsd1306Hal::KMaxColumns - 1, 0, TSsd1306Hal::KMaxPages - 1, iInk }
+            , iLabels{ }
+        {
+        }
+
+        // The ink area points into the layer, so the layer can't be moved or copied
+        CTextLayer( const CTextLayer& ) = delete;
+        CTextLayer& operator=( const CTextLayer& ) = delete;
+
+        /**
+         * @brief Replaces the label text.
+         *
+         * @return TTextBounds The box covered by the text
+         */
+        TTextBounds
+        SetText( size_t aIndex,
+                 const TFont& aFont,
+                 int aX,
+                 int aY,
+                 const char* aText,
+                 bool aOpaque = true ) NOEXCEPT
+        {
+            ClearText( aIndex );
+
+            auto& label = iLabels[ aIndex ];
+            label.iBounds = CTextRenderer::DrawText( iInkArea, aFont, aX, aY, aText, aOpaque );
+            label.iOpaque = aOpaque;
+            label.iUsed = true;
+            CLayer::Invalidate( label.iBounds.iX, label.iBounds.iY, label.iBounds.iWidth,
+                                label.iBounds.iHeight );
+            return label.iBounds;
+        }
+
+        void
+        ClearText( size_t aIndex ) NOEXCEPT
+        {
+            assert( aIndex < taMaxLabels );
+
+            auto& label = iLabels[ aIndex ];
+            if ( label.iUsed )
+            {
+                const auto& bounds = label.iBounds;
+                iInkArea.FillRectangle( bounds.iX, bounds.iY, bounds.iWidth, bounds.iHeight,
+                                        typename TRenderArea::TPixel{ false } );
+                CLayer::Invalidate( bounds.iX, bounds.iY, bounds.iWidth, bounds.iHeight );
+                label.iUsed = false;
+            }
+        }
+
+    protected:
+        void
+        ComposeCell( std::uint8_t aColumn,
+                     std::uint8_t aPage,
+                     TPage* aCell,
+                     std::uint8_t aColumns ) const NOEXCEPT override
+        {
+            const int pageY = aPage * TSsd1306Hal::KPixelsPerPage;
+            TPage boxes[ KCellWidth ] = { };
+            for ( const auto& label : iLabels )
+            {
+                const auto& bounds = label.iBounds;
+                const int begin = std::max< int >( aColumn, bounds.iX );
+                const int end = std::min< int >( aColumn + aColumns, bounds.iX + bounds.iWidth );
+                if ( !label.iUsed || !label.iOpaque || begin >= end || bounds.iY >= pageY + 8
+                     || bounds.iY + bounds.iHeight <= pageY )
+                {
+                    continue;
+                }
+
+                const int beginBit = std::max( bounds.iY - pageY, 0 );
+                const int lastBit = std::min( bounds.iY + bounds.iHeight - 1 - pageY, 7 );
+                const auto mask
+                    = static_cast< TPage >( ( 0xFFu << beginBit ) & ( 0xFFu >> ( 7 - lastBit ) ) );
+                for ( int x = begin; x < end; ++x )
+                {
+                    boxes[ x - aColumn ] |= mask;
+                }
+            }
+
+            const auto* ink
+                = iInkArea.DisplayBuffer( ) + aPage * TSsd1306Hal::KMaxColumns + aColumn;
+            for ( std::uint8_t i = 0; i < aColumns; ++i )
+            {
+                aCell[ i ] = static_cast< TPage >( ( aCell[ i ] & ~boxes[ i ] ) | ink[ i ] );
+            }
+        }
+
+        void
+        InvalidateContent( ) NOEXCEPT override
+        {
+            for ( const auto& label : iLabels )
+            {
+                if ( label.iUsed )
+                {
+                    CLayer::Invalidate( label.iBounds.iX, label.iBounds.iY, label.iBounds.iWidth,
+                                        label.iBounds.iHeight );
+                }
+            }
+        }
+
+    private:
+        struct TLabel
+        {
+            TTextBounds iBounds;
+            bool iOpaque;
+            bool iUsed;
+        };
+
+        TPage iInk[ TSsd1306Hal::KRamSize ];
+        typename TSsd1306::CExternalRenderArea iInkArea;
+        TLabel iLabels[ taMaxLabels ];
+    };
+
+    CSsd1306Compositor( ) NOEXCEPT
+        : iLayers{ }
+        , iLayersNumber{ 0 }
+        , iPendingCells{ }
+        , iStorage{ }
+        , iOutput{ 0,
+                   TSsd1306Hal::KMaxColumns - 1,
+                   0,
+                   TSsd1306Hal::KMaxPages - 1,
+                   iStorage + KBufferAlignment,
+                   true }
+    {
+        // The display RAM content is unknown
+        iPendingCells.MarkAll( );
+    }
+
+    // The output area points into the inline storage, so the compositor can't be moved or copied
+    CSsd1306Compositor( const CSsd1306Compositor& ) = delete;
+    CSsd1306Compositor& operator=( const CSsd1306Compositor& ) = delete;
+
+    /**
+     * @brief Puts the layer on top of the added ones. The layer must outlive the compositor.
+     *
+     * @return true if the layer is added, false if there is no room for it
+     */
+    bool
+    AddLayer( CLayer& aLayer ) NOEXCEPT
+    {
+        if ( iLayersNumber == taMaxLayers )
+        {
+            return false;
+        }
+        iLayers[ iLayersNumber++ ] = &aLayer;
+        aLayer.InvalidateAll( );
+        return true;
+    }
+
+    /**
+     * @brief The flattened image, e.g. to be tracked by the recovering renderer. It is kept up
+     * to date by Render(), which doesn't use the area dirty state.
+     */
+    inline const TRenderArea&
+    Output( ) const NOEXCEPT
+    {
+        return iOutput;
+    }
+
+    /**
+     * @brief Flattens the cells changed by the layers into the output image.
+     */
+    void
+    Compose( ) NOEXCEPT
+    {
+        CCellMap dirtyCells;
+        for ( size_t i = 0; i < iLayersNumber; ++i )
+        {
+            dirtyCells.Merge( iLayers[ i ]->iDirtyCells );
+            iLayers[ i ]->iDirtyCells.Clear( );
+        }
+
+        auto* output = iStorage + KBufferAlignment;
+        for ( std::uint8_t page = 0; page < KCellRows; ++page )
+        {
+            for ( std::uint8_t cellColumn = 0; cellColumn < KCellColumns; ++cellColumn )
+            {
+                if ( ( dirtyCells.iRows[ page ] & ( 1u << cellColumn ) ) == 0 )
+                {
+                    continue;
+                }
+
+                const auto column = static_cast< std::uint8_t >( cellColumn * KCellWidth );
+                const auto columns = static_cast< std::uint8_t >(
+                    std::min< int >( KCellWidth, TSsd1306Hal::KMaxColumns - column ) );
+                TPage cell[ KCellWidth ] = { };
+                for ( size_t i = 0; i < iLayersNumber; ++i )
+                {
+                    if ( iLayers[ i ]->Visible( ) )
+                    {
+                        iLayers[ i ]->ComposeCell( column, page, cell, columns );
+                    }
+                }
+                std::memcpy( output + page * TSsd1306Hal::KMaxColumns + column, cell, columns );
+            }
+        }
+        iPendingCells.Merge( dirtyCells );
+    }
+
+    /**
+     * @brief Composes the changed cells and sends the cells not sent yet as the partial update
+     * regions.
+     *
+     * @param aSentBytes Receives the number of the display buffer bytes sent
+     * @return TErrorCode KOk on success, otherwise the bus error. The regions not sent are sent
+     * by the next render.
+     */
+    TErrorCode
+    Render( TSsd1306& aDisplay, size_t* aSentBytes = nullptr ) NOEXCEPT
+    {
+        Compose( );
+
+        size_t sentBytes = 0;
+        for ( std::uint8_t page = 0; page < KCellRows; ++page )
+        {
+            while ( iPendingCells.iRows[ page ] != 0 )
+            {
+                const auto row = iPendingCells.iRows[ page ];
+                std::uint8_t beginCell = 0;
+                while ( ( row & ( 1u << beginCell ) ) == 0 )
+                {
+                    ++beginCell;
+                }
+                std::uint8_t lastCell = beginCell;
+                for ( auto cell = beginCell + 1; cell < KCellColumns; ++cell )
+                {
+                    if ( ( row & ( 1u << cell ) ) == 0 )
+                    {
+                        if ( cell - lastCell > KMaxMergedGap )
+                        {
+                            break;
+                        }
+                        continue;
+                    }
+                    lastCell = static_cast< std::uint8_t >( cell );
+                }
+
+                // Extend the run down over the pages with the same cells pending
+                const auto cells = CCellMap::CellsMask( beginCell, lastCell );
+                const auto pattern = row & cells;
+                std::uint8_t lastPage = page;
+                while ( lastPage + 1 < KCellRows
+                        && ( iPendingCells.iRows[ lastPage + 1 ] & cells ) == pattern )
+                {
+                    ++lastPage;
+                }
+
+                size_t regionBytes = 0;
+                RETURN_ON_ERROR( aDisplay.RenderRegion(
+                    iOutput, static_cast< std::uint8_t >( beginCell * KCellWidth ),
+                    static_cast< std::uint8_t >( std::min< int >(
+                        lastCell * KCellWidth + KCellWidth - 1, TSsd1306Hal::KMaxColumns - 1 ) ),
+                    page, lastPage, &regionBytes ) );
+                for ( auto sentPage = page; sentPage <= lastPage; ++sentPage )
+                {
+                    iPendingCells.iRows[ sentPage ] &= ~cells;
+                }
+                sentBytes += regionBytes;
+            }
+        }
+
+        if ( aSentBytes != nullptr )
+        {
+            *aSentBytes = sentBytes;
+        }
+        return AbstractPlatform::KOk;
+    }
+
+private:
+    static constexpr size_t KBufferAlignment = TSsd1306::KDefaultBufferAlignment;
+    // The clean cells sent to join two runs: a cell costs 8 data bytes, less than the address
+    // commands and the two transactions of another region
+    static constexpr std::uint8_t KMaxMergedGap = 1;
+
+    CLayer* iLayers[ taMaxLayers ];
+    size_t iLayersNumber;
+    // The composed cells not sent to the display yet
+    CCellMap iPendingCells;
+    alignas( KBufferAlignment ) TPage iStorage[ KBufferAlignment + TSsd1306Hal::KRamSize ];
+    typename TSsd1306::CExternalRenderArea iOutput;
+};
+}  // namespace Ssd1306
+}  // namespace ExternalHardware
@@ -0,0 +1,425 @@
+#pragma once
+#include <AbstractPlatform/common/Platform.hpp>
+#include <ExternalHardware/ssd1306/SSD1306.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+#if defined( __SSE2__ )
+#include <emmintrin.h>
+#elif defined( __aarch64__ ) && defined( __ARM_NEON )
+#include <arm_neon.h>
+#endif
+
+namespace ExternalHardware
+{
+namespace Ssd1306
+{
+/**
+ * @brief Renders the render areas by diffing them against a shadow copy of the display RAM.
+ * Each page row of the area is compared with the shadow, the changed column spans are turned
+ * into a small set of address window + data bursts. The bursts are merged when sending the gap
+ * between them is cheaper than an extra burst, and replaced by one bounding burst when that is
+ * cheaper as a whole.
+ *
+ * The shadow assumes the display RAM has been cleared (CSsd1306::Init does that). Call
+ * Invalidate() whenever the RAM content is unknown (e.g. after the display has been reset or
+ * written around the renderer).
+ */
+template < typename taDisplayType = Ssd1306128x32 >
+class CSsd1306DiffRenderer
+{
+private:
+    using TSsd1306Hal = CSsd1306Hal< taDisplayType >;
+
+public:
+    using TSsd1306 = CSsd1306< taDisplayType >;
+    using TRenderArea = typename TSsd1306::CRenderAreaBase;
+    using TPage = typename TSsd1306::TPage;
+    using TErrorCode = AbstractPlatform::TErrorCode;
+
+    static constexpr size_t KMaxBursts = 16;
+
+    struct TCostModel
+    {
+        // Bus cost of one burst beyond its payload (the address window command stream, the
+        // data control byte, the device addresses and the start/stop conditions) in byte times
+        size_t iBurstOverhead = 12;
+        // Bus cost of a single payload byte in byte times
+        size_t iByteCost = 1;
+    };
+
+    struct TBurst
+    {
+        std::uint8_t iBeginColumn;
+        std::uint8_t iLastColumn;
+        std::uint8_t iBeginPage;
+        std::uint8_t iLastPage;
+    };
+
+    explicit CSsd1306DiffRenderer( TSsd1306& aDisplay, TCostModel aCostModel = TCostModel{ } )
+        : iDisplay{ aDisplay }
+        , iCostModel{ aCostModel }
+        , iUnknownPages{ 0 }
+        , iUnknownColumns{ }
+        , iShadow{ }
+    {
+    }
+
+    /**
+     * @brief Marks the whole shadow as unknown, so the next render of any area sends the area
+     * page rows completely. The columns become known again once an area covering them has
+     * been sent.
+     */
+    inline void
+    Invalidate( ) NOEXCEPT
+    {
+        iUnknownPages = KAllPages;
+        std::memset( iUnknownColumns, 0xFF, sizeof( iUnknownColumns ) );
+    }
+
+    inline TSsd1306&
+    Display( ) NOEXCEPT
+    {
+        return iDisplay;
+    }
+
+    inline void
+    SetCostModel( TCostModel aCostModel ) NOEXCEPT
+    {
+        iCostModel = aCostModel;
+    }
+
+    /**
+     * @brief Sends the difference between the render area and the display RAM content.
+     *
+     * @param aRenderArea The render area to be rendered
+     * @param aSkippedBytes Receives the number of the display buffer bytes skipped as unchanged
+     * @return TErrorCode KOk on success, otherwise the first bus error. The shadow of the burst
+     * that has failed no longer matches the area, so the next render sends it again.
+     */
+    TErrorCode
+    Render( const TRenderArea& aRenderArea, size_t* aSkippedBytes = nullptr )
+    {
+        TBurst bursts[ KMaxBursts ];
+        size_t burstsNumber = 0;
+        bool overflow = false;
+
+        const auto* displayBuffer = aRenderArea.DisplayBuffer( );
+        const size_t columns = aRenderArea.Columns( );
+        const size_t mergeGap
+            = iCostModel.iBurstOverhead / std::max< size_t >( iCostModel.iByteCost, 1 );
+
+        for ( size_t row = 0; row < aRenderArea.Rows( ) && !overflow; ++row )
+        {
+            const size_t page = aRenderArea.BeginPage( ) + row;
+            const auto* areaRow = displayBuffer + row * columns;
+            const auto* shadowRow
+                = iShadow + page * TSsd1306Hal::KMaxColumns + aRenderArea.BeginColumn( );
+
+            if ( HasUnknownColumns( page, aRenderArea.BeginColumn( ), columns ) )
+            {
+                overflow = !AddBurst( bursts, burstsNumber, 0, columns - 1, row );
+                continue;
+            }
+
+            size_t position = FindFirstDifference( areaRow, shadowRow, 0, columns );
+            while ( position < columns && !overflow )
+            {
+                const size_t spanBegin = position;
+                size_t spanLast = position;
+                for ( ;; )
+                {
+                    position = FindFirstDifference( areaRow, shadowRow, spanLast + 1, columns );
+                    if ( position == columns || position - spanLast - 1 > mergeGap )
+                    {
+                        break;
+                    }
+                    spanLast = position;
+                }
+                overflow = !AddBurst( bursts, burstsNumber, spanBegin, spanLast, row );
+            }
+        }
+
+        if ( overflow || burstsNumber != 0 )
+        {
+            const auto boundingBurst = overflow ? WholeAreaBurst( aRenderArea )
+                                                : BoundingBurst( bursts, burstsNumber );
+            if ( overflow || BurstCost( boundingBurst ) <= BurstsCost( bursts, burstsNumber ) )
+            {
+                bursts[ 0 ] = boundingBurst;
+                burstsNumber = 1;
+            }
+        }
+
+        size_t sentBytes = 0;
+        for ( size_t i = 0; i < burstsNumber; ++i )
+        {
+            const auto& burst = bursts[ i ];
+            size_t burstBytes = 0;
+            const auto result
+                = iDisplay.RenderRegion( aRenderArea, burst.iBeginColumn, burst.iLastColumn,
+                                         burst.iBeginPage, burst.iLastPage, &burstBytes );
+            if ( result != AbstractPlatform::KOk )
+            {
+                // The bursts sent so far are in the RAM, the failed one is unknown
+                for ( size_t sent = 0; sent < i; ++sent )
+                {
+                    UpdateShadow( aRenderArea, bursts[ sent ], true );
+                }
+                UpdateShadow( aRenderArea, burst, false );
+                return result;
+            }
+            sentBytes += burstBytes;
+        }
+
+        UpdateShadow( aRenderArea );
+        if ( aSkippedBytes != nullptr )
+        {
+            *aSkippedBytes = aRenderArea.GetDisplayBufferSize( ) - sentBytes;
+        }
+        return AbstractPlatform::KOk;
+    }
+
+private:
+    static constexpr std::uint32_t KAllPages
+        = static_cast< std::uint32_t >( ( 1ull << TSsd1306Hal::KMaxPages ) - 1u );
+
+    // The bytes of the per page bitmap of the unknown columns
+    static constexpr size_t KColumnBitmapSize = ( TSsd1306Hal::KMaxColumns + 7 ) / 8;
+
+    static constexpr std::uint32_t
+    PageMask( size_t aPage )
+    {
+        return static_cast< std::uint32_t >( 1u ) << aPage;
+    }
+
+    /**
+     * @brief Checks if any of the columns [aBeginColumn, aBeginColumn + aColumns) of the page
+     * is unknown.
+     */
+    bool
+    HasUnknownColumns( size_t aPage, size_t aBeginColumn, size_t aColumns ) const NOEXCEPT
+    {
+        if ( ( iUnknownPages & PageMask( aPage ) ) == 0 )
+        {
+            return false;
+        }
+
+        const auto* bitmap = iUnknownColumns[ aPage ];
+        for ( size_t column = aBeginColumn; column < aBeginColumn + aColumns; ++column )
+        {
+            if ( ( bitmap[ column / 8 ] & ( 1u << ( column % 8 ) ) ) != 0 )
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Marks the columns [aBeginColumn, aBeginColumn + aColumns) of the page as known,
+     * the page is known as a whole once none of its columns is unknown.
+     */
+    void
+    MarkColumnsKnown( size_t aPage, size_t aBeginColumn, size_t aColumns ) NOEXCEPT
+    {
+        if ( ( iUnknownPages & PageMask( aPage ) ) == 0 )
+        {
+            return;
+        }
+
+        auto* bitmap = iUnknownColumns[ aPage ];
+        for ( size_t column = aBeginColumn; column < aBeginColumn + aColumns; ++column )
+        {
+            bitmap[ column / 8 ] &= static_cast< std::uint8_t >( ~( 1u << ( column % 8 ) ) );
+        }
+        if ( !HasUnknownColumns( aPage, 0, TSsd1306Hal::KMaxColumns ) )
+        {
+            iUnknownPages &= ~PageMask( aPage );
+        }
+    }
+
+    /**
+     * @brief Appends the span of the area row to the burst list. The span is merged into the
+     * previous burst if it continues it on the next page with exactly the same columns.
+     *
+     * @return true if the burst has been added, false if the burst list is full
+     */
+    static bool
+    AddBurst( TBurst* aBursts,
+              size_t& aBurstsNumber,
+              size_t aBeginColumn,
+              size_t aLastColumn,
+              size_t aRow )
+    {
+        if ( aBurstsNumber != 0 )
+        {
+            auto& previous = aBursts[ aBurstsNumber - 1 ];
+            if ( previous.iBeginColumn == aBeginColumn && previous.iLastColumn == aLastColumn
+                 && previous.iLastPage + 1u == aRow )
+            {
+                previous.iLastPage = static_cast< std::uint8_t >( aRow );
+                return true;
+            }
+        }
+
+        if ( aBurstsNumber == KMaxBursts )
+        {
+            return false;
+        }
+
+        aBursts[ aBurstsNumber++ ] = TBurst{ static_cast< std::uint8_t >( aBeginColumn ),
+                                             static_cast< std::uint8_t >( aLastColumn ),
+                                             static_cast< std::uint8_t >( aRow ),
+                                             static_cast< std::uint8_t >( aRow ) };
+        return true;
+    }
+
+    static constexpr TBurst
+    WholeAreaBurst( const TRenderArea& aRenderArea )
+    {
+        return TBurst{ 0, static_cast< std::uint8_t >( aRenderArea.Columns( ) - 1 ), 0,
+                       static_cast< std::uint8_t >( aRenderArea.Rows( ) - 1 ) };
+    }
+
+    static TBurst
+    BoundingBurst( const TBurst* aBursts, size_t aBurstsNumber )
+    {
+        assert( aBurstsNumber != 0 );
+
+        TBurst result = aBursts[ 0 ];
+        for ( size_t i = 1; i < aBurstsNumber; ++i )
+        {
+            result.iBeginColumn = std::min( result.iBeginColumn, aBursts[ i ].iBeginColumn );
+            result.iLastColumn = std::max( result.iLastColumn, aBursts[ i ].iLastColumn );
+            result.iBeginPage = std::min( result.iBeginPage, aBursts[ i ].iBeginPage );
+            result.iLastPage = std::max( result.iLastPage, aBursts[ i ].iLastPage );
+        }
+        return result;
+    }
+
+    inline size_t
+    BurstCost( const TBurst& aBurst ) const
+    {
+        const size_t bytes = ( aBurst.iLastColumn - aBurst.iBeginColumn + 1u )
+                             * ( aBurst.iLastPage - aBurst.iBeginPage + 1u );
+        return iCostModel.iBurstOverhead + bytes * iCostModel.iByteCost;
+    }
+
+    size_t
+    BurstsCost( const TBurst* aBursts, size_t aBurstsNumber ) const
+    {
+        size_t result = 0;
+        for ( size_t i = 0; i < aBurstsNumber; ++i )
+        {
+            result += BurstCost( aBursts[ i ] );
+        }
+        return result;
+    }
+
+    void
+    UpdateShadow( const TRenderArea& aRenderArea )
+    {
+        const size_t columns = aRenderArea.Columns( );
+        for ( size_t row = 0; row < aRenderArea.Rows( ); ++row )
+        {
+            const size_t page = aRenderArea.BeginPage( ) + row;
+            std::memcpy( iShadow + page * TSsd1306Hal::KMaxColumns + aRenderArea.BeginColumn( ),
+                         aRenderArea.DisplayBuffer( ) + row * columns, columns );
+            MarkColumnsKnown( page, aRenderArea.BeginColumn( ), columns );
+        }
+    }
+
+    /**
+     * @brief Copies the burst of the area to the shadow if it has been sent, otherwise stores
+     * its complement there, so every byte of the burst differs from the area on the next render.
+     * Either way the burst columns are known afterwards.
+     */
+    void
+    UpdateShadow( const TRenderArea& aRenderArea, const TBurst& aBurst, bool aSent )
+    {
+        const size_t columns = aRenderArea.Columns( );
+        for ( size_t row = aBurst.iBeginPage; row <= aBurst.iLastPage; ++row )
+        {
+            const size_t page = aRenderArea.BeginPage( ) + row;
+            auto* shadowRow
+                = iShadow + page * TSsd1306Hal::KMaxColumns + aRenderArea.BeginColumn( );
+            const auto* areaRow = aRenderArea.DisplayBuffer( ) + row * columns;
+            for ( size_t column = aBurst.iBeginColumn; column <= aBurst.iLastColumn; ++column )
+            {
+                shadowRow[ column ] = aSent ? areaRow[ column ]
+                                            : static_cast< TPage >( ~areaRow[ column ] );
+            }
+            MarkColumnsKnown( page, aRenderArea.BeginColumn( ) + aBurst.iBeginColumn,
+                              aBurst.iLastColumn - aBurst.iBeginColumn + 1u );
+        }
+    }
+
+    /**
+     * @brief Finds the first byte that differs between the two buffers.
+     *
+     * @return size_t The index of the first different byte in [aBegin, aEnd) or aEnd if the
+     * buffers are equal within the range
+     */
+    static size_t
+    FindFirstDifference( const TPage* aLeft, const TPage* aRight, size_t aBegin, size_t aEnd )
+    {
+        size_t i = aBegin;
+#if defined( __SSE2__ )
+        for ( ; i + sizeof( __m128i ) <= aEnd; i += sizeof( __m128i ) )
+        {
+            const __m128i left = _mm_loadu_si128( reinterpret_cast< const __m128i* >( aLeft + i ) );
+            const __m128i right
+                = _mm_loadu_si128( reinterpret_cast< const __m128i* >( aRight + i ) );
+            const unsigned equalMask
+                = static_cast< unsigned >( _mm_movemask_epi8( _mm_cmpeq_epi8( left, right ) ) );
+            if ( equalMask != 0xFFFFu )
+            {
+                return i + static_cast< size_t >( __builtin_ctz( ~equalMask ) );
+            }
+        }
+#elif defined( __aarch64__ ) && defined( __ARM_NEON )
+        for ( ; i + sizeof( uint8x16_t ) <= aEnd; i += sizeof( uint8x16_t ) )
+        {
+            const uint8x16_t difference
+                = veorq_u8( vld1q_u8( aLeft + i ), vld1q_u8( aRight + i ) );
+            if ( vmaxvq_u8( difference ) != 0 )
+            {
+                break;
+            }
+        }
+#else
+        for ( ; i + sizeof( std::uint64_t ) <= aEnd; i += sizeof( std::uint64_t ) )
+        {
+            std::uint64_t left;
+            std::uint64_t right;
+            std::memcpy( &left, aLeft + i, sizeof( left ) );
+            std::memcpy( &right, aRight + i, sizeof( right ) );
+            if ( left != right )
+            {
+                break;
+            }
+        }
+#endif
+        for ( ; i < aEnd; ++i )
+        {
+            if ( aLeft[ i ] != aRight[ i ] )
+            {
+                break;
+            }
+        }
+        return i;
+    }
+
+    TSsd1306& iDisplay;
+    TCostModel iCostModel;
+    // The pages having unknown columns and the unknown columns of each page, one bit a column
+    std::uint32_t iUnknownPages;
+    std::uint8_t iUnknownColumns[ TSsd1306Hal::KMaxPages ][ KColumnBitmapSize ];
+    TPage iShadow[ TSsd1306Hal::KRamSize ];
+};
+}  // namespace Ssd1306
+}  // namespace ExternalHardware
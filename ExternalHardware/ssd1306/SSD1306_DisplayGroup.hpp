@@ -0,0 +1,382 @@
+#pragma once
+#include <AbstractPlatform/common/Platform.hpp>
+#include <AbstractPlatform/common/ErrorCode.hpp>
+#include <AbstractPlatform/i2c/AbstractI2C.hpp>
+#include <ExternalHardware/ssd1306/SSD1306.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <algorithm>
+
+namespace ExternalHardware
+{
+namespace Ssd1306
+{
+/**
+ * @brief Renders several displays sharing one I2C bus, directly or behind a TCA9548A-style
+ * channel multiplexer. Every Poll() call performs one bounded transaction (the address windows
+ * or a data chunk) of one display, so the displays are updated interleaved instead of each one
+ * holding the bus for a whole frame.
+ *
+ * The changes of a render area are picked up as soon as its display is idle. The displays
+ * reachable without a multiplexer switch are served round-robin first; when none of them has
+ * pending data the multiplexer is switched to the display waiting the longest.
+ *
+ * @note The displays and the render areas are owned by the caller and must outlive the group.
+ * Poll() must not be preempted by the drawing into the render areas. A selected multiplexer
+ * channel is connected to the bus, so the multiplexed displays can't share their addresses with
+ * the direct ones.
+ *
+ * @tparam taDisplayType The display type
+ * @tparam taMaxDisplays The maximum number of the displays in the group
+ */
+template < typename taDisplayType = Ssd1306128x32, size_t taMaxDisplays = 4 >
+class CSsd1306DisplayGroup
+{
+public:
+    using TSsd1306 = CSsd1306< taDisplayType >;
+    using TRenderArea = typename TSsd1306::CRenderAreaBase;
+    using TRegion = typename TSsd1306::TRegion;
+    using TErrorCode = AbstractPlatform::TErrorCode;
+
+    static constexpr std::uint8_t KNoMuxChannel = 0xFF;
+    static constexpr std::uint8_t KMaxMuxChannels = 8;
+    static constexpr std::uint8_t KDefaultMuxAddress = 0x70;
+    static constexpr size_t KDefaultChunkSize = 31;
+
+    struct TDisplayStatistics
+    {
+        std::uint32_t iFrames;
+        std::uint32_t iFailedFrames;
+        // The time from picking the changes up until the last chunk is sent, in microseconds
+        // or in Poll() calls without the clock
+        std::uint32_t iLastLatency;
+        std::uint32_t iMaxLatency;
+        std::uint64_t iTotalLatency;
+
+        inline std::uint32_t
+        AverageLatency( ) const NOEXCEPT
+        {
+            return iFrames != 0 ? static_cast< std::uint32_t >( iTotalLatency / iFrames ) : 0;
+        }
+    };
+
+    /**
+     * @brief Construct a new display group
+     *
+     * @param aBus The bus shared by the displays, used to switch the multiplexer
+     * @param aClock The latency clock, without it the latencies are counted in Poll() calls
+     * @param aChunkSize The maximum number of the data bytes sent by one Poll() call
+     * @param aMuxAddress The address of the multiplexer
+     */
+    explicit CSsd1306DisplayGroup( AbstractPlatform::IAbstractI2CBus& aBus,
+                                   TClock aClock = nullptr,
+                                   size_t aChunkSize = KDefaultChunkSize,
+                                   std::uint8_t aMuxAddress = KDefaultMuxAddress ) NOEXCEPT
+        : iBus{ aBus }
+        , iClock{ aClock }
+        , iChunkSize{ std::min( std::max< size_t >( aChunkSize, 1 ), TSsd1306::KMaxChunkSize ) }
+        , iMuxAddress{ aMuxAddress }
+        , iMuxChannel{ KUnknownMuxChannel }
+        , iMuxSwitches{ 0 }
+        , iSize{ 0 }
+        , iLastServed{ 0 }
+        , iPolls{ 0 }
+        , iJobSequence{ 0 }
+    {
+    }
+
+    /**
+     * @brief Adds the display to the group.
+     *
+     * @param aDisplay The display, initialized by the caller
+     * @param aRenderArea The render area rendered to the display whenever it is dirty
+     * @param aMuxChannel The multiplexer channel of the display or KNoMuxChannel if the display
+     * is on the bus directly
+     * @param aIndex Receives the index of the display in the group
+     * @return TErrorCode KOk if succeed, KGenericError if the group is full
+     */
+    TErrorCode
+    AddDisplay( TSsd1306& aDisplay,
+                const TRenderArea& aRenderArea,
+                std::uint8_t aMuxChannel = KNoMuxChannel,
+                size_t* aIndex = nullptr ) NOEXCEPT
+    {
+        assert( aMuxChannel < KMaxMuxChannels || aMuxChannel == KNoMuxChannel );
+#if !defined( NDEBUG )
+        for ( size_t i = 0; i < iSize; ++i )
+        {
+            const bool direct = iMembers[ i ].iMuxChannel == KNoMuxChannel;
+            assert( direct == ( aMuxChannel == KNoMuxChannel )
+                    || iMembers[ i ].iDisplay->Hal( ).DeviceAddress( )
+                           != aDisplay.Hal( ).DeviceAddress( ) );
+        }
+#endif
+
+        if ( iSize == taMaxDisplays )
+        {
+            return AbstractPlatform::KGenericError;
+        }
+
+        auto& member = iMembers[ iSize ];
+        member = TMember{ };
+        member.iDisplay = &aDisplay;
+        member.iRenderArea = &aRenderArea;
+        member.iMuxChannel = aMuxChannel;
+        if ( aIndex != nullptr )
+        {
+            *aIndex = iSize;
+        }
+        ++iSize;
+        return AbstractPlatform::KOk;
+    }
+
+    /**
+     * @brief Picks the new changes up and performs the next transaction.
+     *
+     * @return true if there is some work left, false if all the displays are up to date
+     */
+    bool
+    Poll( ) NOEXCEPT
+    {
+        ++iPolls;
+        StartJobs( );
+
+        const size_t index = SelectMember( );
+        if ( index == iSize )
+        {
+            return false;
+        }
+
+        auto& member = iMembers[ index ];
+        const auto channel = RequiredMuxChannel( member );
+        if ( channel != iMuxChannel )
+        {
+            if ( !SelectMuxChannel( channel ) )
+            {
+                return true;
+            }
+        }
+
+        iLastServed = index;
+        const auto result
+            = member.iWindowSent
+                  ? member.iDisplay->SendRegionChunk( *member.iRenderArea, member.iRegion,
+                                                      member.iSentBytes, iChunkSize )
+                  : member.iDisplay->SendRegionWindow( *member.iRenderArea, member.iRegion );
+        member.iWindowSent = true;
+
+        if ( result != AbstractPlatform::KOk )
+        {
+            // The display content of the region is unknown now, send it again
+            member.iDisplay->RestoreDirtyRegion( *member.iRenderArea, member.iRegion );
+            member.iActive = false;
+            ++member.iStatistics.iFailedFrames;
+        }
+        else if ( member.iSentBytes == TSsd1306::RegionSize( member.iRegion ) )
+        {
+            member.iActive = false;
+            OnFrameCompleted( member );
+        }
+
+        return Busy( );
+    }
+
+    /**
+     * @brief Checks if any display has a frame in progress or pending changes.
+     */
+    bool
+    Busy( ) const NOEXCEPT
+    {
+        for ( size_t i = 0; i < iSize; ++i )
+        {
+            if ( iMembers[ i ].iActive || iMembers[ i ].iRenderArea->IsDirty( ) )
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    inline size_t
+    Size( ) const NOEXCEPT
+    {
+        return iSize;
+    }
+
+    inline const TDisplayStatistics&
+    Statistics( size_t aIndex ) const NOEXCEPT
+    {
+        assert( aIndex < iSize );
+        return iMembers[ aIndex ].iStatistics;
+    }
+
+    inline void
+    ResetStatistics( ) NOEXCEPT
+    {
+        for ( size_t i = 0; i < iSize; ++i )
+        {
+            iMembers[ i ].iStatistics = TDisplayStatistics{ };
+        }
+        iMuxSwitches = 0;
+    }
+
+    inline std::uint32_t
+    MuxSwitches( ) const NOEXCEPT
+    {
+        return iMuxSwitches;
+    }
+
+private:
+    // The multiplexer state after a failed switch or before the first one
+    static constexpr std::uint8_t KUnknownMuxChannel = 0xFE;
+
+    struct TMember
+    {
+        TSsd1306* iDisplay;
+        const TRenderArea* iRenderArea;
+        std::uint8_t iMuxChannel;
+        TRegion iRegion;
+        size_t iSentBytes;
+        std::uint32_t iStartTime;
+        std::uint32_t iSequence;
+        bool iWindowSent;
+        bool iActive;
+        TDisplayStatistics iStatistics;
+    };
+
+    inline std::uint32_t
+    Now( ) const NOEXCEPT
+    {
+        return iClock != nullptr ? iClock( ) : iPolls;
+    }
+
+    void
+    StartJobs( ) NOEXCEPT
+    {
+        for ( size_t i = 0; i < iSize; ++i )
+        {
+            auto& member = iMembers[ i ];
+            if ( !member.iActive && member.iDisplay->TakeDirtyRegion( *member.iRenderArea,
+                                                                      member.iRegion ) )
+            {
+                member.iActive = true;
+                member.iWindowSent = false;
+                member.iSentBytes = 0;
+                member.iStartTime = Now( );
+                member.iSequence = iJobSequence++;
+            }
+        }
+    }
+
+    /**
+     * @brief The multiplexer channel the member can be reached through. The direct displays are
+     * reachable through any channel, so a group without multiplexed displays never touches the
+     * multiplexer.
+     */
+    inline std::uint8_t
+    RequiredMuxChannel( const TMember& aMember ) const NOEXCEPT
+    {
+        return aMember.iMuxChannel != KNoMuxChannel ? aMember.iMuxChannel : iMuxChannel;
+    }
+
+    /**
+     * @brief The next member to be served: the ones reachable through the current multiplexer
+     * channel round-robin. The channel is switched when the frame waiting the longest is behind
+     * another one, so a busy channel can't starve the others for longer than one frame of each
+     * of its displays.
+     *
+     * @return size_t The member index or iSize if none has pending data
+     */
+    size_t
+    SelectMember( ) const NOEXCEPT
+    {
+        size_t next = iSize;
+        size_t oldestReachable = iSize;
+        size_t oldestUnreachable = iSize;
+        for ( size_t i = 1; i <= iSize; ++i )
+        {
+            const size_t index = ( iLastServed + i ) % iSize;
+            const auto& member = iMembers[ index ];
+            if ( !member.iActive )
+            {
+                continue;
+            }
+
+            if ( RequiredMuxChannel( member ) == iMuxChannel )
+            {
+                next = next == iSize ? index : next;
+                oldestReachable = Older( index, oldestReachable );
+            }
+            else
+            {
+                oldestUnreachable = Older( index, oldestUnreachable );
+            }
+        }
+
+        if ( oldestUnreachable != iSize
+             && Older( oldestUnreachable, oldestReachable ) == oldestUnreachable )
+        {
+            return oldestUnreachable;
+        }
+        return next;
+    }
+
+    /**
+     * @brief The member of the two whose frame has been picked up earlier, an invalid index
+     * loses to any valid one.
+     */
+    inline size_t
+    Older( size_t aIndex, size_t aOtherIndex ) const NOEXCEPT
+    {
+        if ( aOtherIndex == iSize )
+        {
+            return aIndex;
+        }
+        // The sequence numbers are compared by distance to survive the wrap-around
+        const auto distance = static_cast< std::int32_t >( iMembers[ aIndex ].iSequence
+                                                           - iMembers[ aOtherIndex ].iSequence );
+        return distance < 0 ? aIndex : aOtherIndex;
+    }
+
+    bool
+    SelectMuxChannel( std::uint8_t aChannel ) NOEXCEPT
+    {
+        const std::uint8_t channelMask
+            = aChannel == KNoMuxChannel ? 0x00 : static_cast< std::uint8_t >( 1u << aChannel );
+        ++iMuxSwitches;
+        if ( iBus.Write( iMuxAddress, &channelMask, sizeof( channelMask ) )
+             != sizeof( channelMask ) )
+        {
+            iMuxChannel = KUnknownMuxChannel;
+            return false;
+        }
+        iMuxChannel = aChannel;
+        return true;
+    }
+
+    void
+    OnFrameCompleted( TMember& aMember ) NOEXCEPT
+    {
+        auto& statistics = aMember.iStatistics;
+        const std::uint32_t latency = Now( ) - aMember.iStartTime;
+        ++statistics.iFrames;
+        statistics.iLastLatency = latency;
+        statistics.iMaxLatency = std::max( statistics.iMaxLatency, latency );
+        statistics.iTotalLatency += latency;
+    }
+
+    AbstractPlatform::IAbstractI2CBus& iBus;
+    const TClock iClock;
+    const size_t iChunkSize;
+    const std::uint8_t iMuxAddress;
+    std::uint8_t iMuxChannel;
+    std::uint32_t iMuxSwitches;
+    TMember iMembers[ taMaxDisplays ];
+    size_t iSize;
+    size_t iLastServed;
+    std::uint32_t iPolls;
+    std::uint32_t iJobSequence;
+};
+}  // namespace Ssd1306
+}  // namespace ExternalHardware
@@ -0,0 +1,682 @@
+#pragma once
+#include <AbstractPlatform/common/Platform.hpp>
+#include <AbstractPlatform/i2c/AbstractI2C.hpp>
+#include <ExternalHardware/ssd1306/SSD1306_HAL.hpp>
+#include <ExternalHardware/ssd1306/SSD1306_Transfer.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+namespace ExternalHardware
+{
+namespace Ssd1306
+{
+/**
+ * @brief Host side stand-in of the I2C bus with an SSD1306 attached. The written transactions
+ * are decoded by the control byte protocol: the commands update the emulated controller state
+ * and the data lands in the emulated GRAM according to the addressing mode and the column/page
+ * windows. The panel image is derived from the GRAM, the start line, the display offset, the
+ * segment remap and the COM scan direction.
+ *
+ * The bus time is modelled at the configured SCL clock: every transaction costs a start
+ * condition, the address byte, 9 clocks per byte and a stop condition. The gathered writes are
+ * accepted like the contiguous ones; a bus driver limit can be modelled by the maximum transfer
+ * size, the longer transactions are NACKed.
+ *
+ * The continuous horizontal scroll moves the GRAM content of its pages by a column every step
+ * interval, the frames are advanced by the host with AdvanceFrames(). The diagonal and the
+ * vertical scrolls are latched but not animated.
+ *
+ * @note Reads are not supported by the controller over I2C, so they are NACKed.
+ *
+ * @tparam taDisplayType The display type, defines the controller RAM and the panel geometry
+ */
+template < typename taDisplayType = Ssd1306128x32 >
+class CSsd1306Emulator : public IScatterGatherI2CBus
+{
+public:
+    using TSsd1306Hal = CSsd1306Hal< taDisplayType >;
+
+    static constexpr std::uint8_t KRamColumns = TSsd1306Hal::KRamColumns;
+    static constexpr std::uint8_t KRamPages = TSsd1306Hal::KRamPages;
+    static constexpr std::uint8_t KRamRows = 64;
+    static constexpr std::uint32_t KDefaultClock = 400000;  // Fast mode
+
+    enum class TAddressingMode : std::uint8_t
+    {
+        Horizontal = 0x00,
+        Vertical = 0x01,
+        Page = 0x02
+    };
+
+    struct TStatistics
+    {
+        std::uint32_t iTransactions;
+        // The transactions gathered from several segments
+        std::uint32_t iGatheredTransactions;
+        std::uint32_t iNacks;
+        std::uint32_t iUnknownCommands;
+        // All the bytes on the wire including the address and the control bytes
+        std::uint64_t iWireBytes;
+        std::uint64_t iCommandBytes;
+        std::uint64_t iDataBytes;
+        // The most data bytes a transaction has carried, the chunk size of the RAM data
+        std::uint32_t iMaxTransactionDataBytes;
+        // The GRAM writes while the scroll is active, which the controller doesn't allow
+        std::uint64_t iDataBytesWhileScrolling;
+        // The SCL clock periods spent on the bus
+        std::uint64_t iBusClocks;
+    };
+
+    explicit CSsd1306Emulator( std::uint8_t aDeviceAddress = TSsd1306Hal::KDefaultAddress,
+                               std::uint32_t aClock = KDefaultClock ) NOEXCEPT
+        : iDeviceAddress{ aDeviceAddress }
+        , iClock{ aClock }
+    {
+        assert( aClock != 0 );
+        PowerOn( );
+    }
+
+    int
+    Read( std::uint8_t aAddress,
+          std::uint8_t* aDst,
+          size_t aLength,
+          bool aNoStop = false ) override
+    {
+        ( void )aAddress;
+        ( void )aDst;
+        ( void )aLength;
+        AccountTransaction( 0, aNoStop );
+        ++iStatistics.iNacks;
+        return -1;
+    }
+
+    int
+    Write( std::uint8_t aAddress,
+           const std::uint8_t* aSrc,
+           size_t aLength,
+           bool aNoStop = false ) override
+    {
+        assert( aSrc != nullptr || aLength == 0 );
+
+        const TTransferSegment segment{ aSrc, aLength };
+        return WriteSegments( aAddress, &segment, 1, aNoStop );
+    }
+
+    int
+    WriteGathered( std::uint8_t aAddress,
+                   const TTransferSegment* aSegments,
+                   size_t aSegmentsNumber,
+                   bool aNoStop = false ) override
+    {
+        assert( aSegments != nullptr || aSegmentsNumber == 0 );
+
+        ++iStatistics.iGatheredTransactions;
+        return WriteSegments( aAddress, aSegments, aSegmentsNumber, aNoStop );
+    }
+
+    /**
+     * @brief Sets the longest transaction accepted, 0 for unlimited.
+     */
+    inline void
+    SetMaxTransferSize( size_t aMaxTransferSize ) NOEXCEPT
+    {
+        iMaxTransferSize = aMaxTransferSize;
+    }
+
+    /**
+     * @brief Brings the controller to its reset state. The GRAM content is kept, like the
+     * hardware does.
+     */
+    void
+    PowerOn( ) NOEXCEPT
+    {
+        iMode = TAddressingMode::Page;
+        iColumnStart = 0;
+        iColumnEnd = KRamColumns - 1;
+        iPageStart = 0;
+        iPageEnd = KRamPages - 1;
+        iPageModeColumnStart = 0;
+        iColumn = 0;
+        iPage = 0;
+        iStartLine = 0;
+        iDisplayOffset = 0;
+        iMultiplexRatio = KRamRows - 1;
+        iContrast = 0x7F;
+        iComPins = 0x12;
+        iSegmentRemap = false;
+        iComScanReversed = false;
+        iInverse = false;
+        iEntireDisplayOn = false;
+        iDisplayOn = false;
+        iChargePump = false;
+        iScrollActive = false;
+        iScrollLeft = false;
+        iScrollStartPage = 0;
+        iScrollEndPage = 0;
+        iScrollStepFrames = 0;
+        iScrollFrames = 0;
+        iPendingCommandSize = 0;
+        iExpectedCommandSize = 0;
+    }
+
+    /**
+     * @brief Runs the panel refresh for the number of frames, which moves the GRAM content of
+     * the active horizontal scroll a column every step interval frames.
+     */
+    void
+    AdvanceFrames( std::uint32_t aFrames ) NOEXCEPT
+    {
+        if ( !iScrollActive || iScrollStepFrames == 0 )
+        {
+            return;
+        }
+
+        iScrollFrames += aFrames;
+        for ( ; iScrollFrames >= iScrollStepFrames; iScrollFrames -= iScrollStepFrames )
+        {
+            for ( size_t page = iScrollStartPage; page <= iScrollEndPage; ++page )
+            {
+                auto* row = iRam[ page ];
+                if ( iScrollLeft )
+                {
+                    std::rotate( row, row + 1, row + KRamColumns );
+                }
+                else
+                {
+                    std::rotate( row, row + KRamColumns - 1, row + KRamColumns );
+                }
+            }
+        }
+    }
+
+    inline void
+    SetClock( std::uint32_t aClock ) NOEXCEPT
+    {
+        assert( aClock != 0 );
+        iClock = aClock;
+    }
+
+    inline const TStatistics&
+    Statistics( ) const NOEXCEPT
+    {
+        return iStatistics;
+    }
+
+    inline void
+    ResetStatistics( ) NOEXCEPT
+    {
+        iStatistics = TStatistics{ };
+    }
+
+    /**
+     * @brief The bus time spent since the last ResetStatistics() at the configured clock.
+     */
+    inline std::uint64_t
+    BusTimeNs( ) const NOEXCEPT
+    {
+        return iStatistics.iBusClocks * 1000000000ull / iClock;
+    }
+
+    inline std::uint8_t
+    RamByte( std::uint8_t aColumn, std::uint8_t aPage ) const NOEXCEPT
+    {
+        assert( aColumn < KRamColumns );
+        assert( aPage < KRamPages );
+        return iRam[ aPage ][ aColumn ];
+    }
+
+    inline const std::uint8_t*
+    RamPage( std::uint8_t aPage ) const NOEXCEPT
+    {
+        assert( aPage < KRamPages );
+        return iRam[ aPage ];
+    }
+
+    /**
+     * @brief The lit state of the panel pixel driven by the segment and the COM line. The
+     * segments are counted from the first one wired to the panel, which shows the panel column
+     * offset RAM column with the segment remap of the display type traits.
+     */
+    bool
+    Pixel( std::uint8_t aSegment, std::uint8_t aCom ) const NOEXCEPT
+    {
+        assert( aSegment < TSsd1306Hal::KPixelWidth );
+        assert( aCom < TSsd1306Hal::KPixelHight );
+
+        if ( !iDisplayOn || aCom > iMultiplexRatio )
+        {
+            return false;
+        }
+        if ( iEntireDisplayOn )
+        {
+            return true;
+        }
+
+        const size_t scanRow = iComScanReversed ? iMultiplexRatio - aCom : aCom;
+        const size_t ramRow = ( scanRow + iDisplayOffset + iStartLine ) % KRamRows;
+        const size_t segment = KFirstSegment + aSegment;
+        const size_t column = iSegmentRemap ? KRamColumns - 1u - segment : segment;
+        const bool lit = ( ( iRam[ ramRow / 8 ][ column ] >> ( ramRow % 8 ) ) & 0x01 ) != 0;
+        return lit != iInverse;
+    }
+
+    // The controller state
+    inline TAddressingMode
+    AddressingMode( ) const NOEXCEPT
+    {
+        return iMode;
+    }
+
+    inline std::uint8_t
+    Column( ) const NOEXCEPT
+    {
+        return iColumn;
+    }
+
+    inline std::uint8_t
+    Page( ) const NOEXCEPT
+    {
+        return iPage;
+    }
+
+    inline std::uint8_t
+    StartLine( ) const NOEXCEPT
+    {
+        return iStartLine;
+    }
+
+    inline std::uint8_t
+    DisplayOffset( ) const NOEXCEPT
+    {
+        return iDisplayOffset;
+    }
+
+    inline std::uint8_t
+    MultiplexRatio( ) const NOEXCEPT
+    {
+        return iMultiplexRatio;
+    }
+
+    inline std::uint8_t
+    Contrast( ) const NOEXCEPT
+    {
+        return iContrast;
+    }
+
+    inline bool
+    SegmentRemap( ) const NOEXCEPT
+    {
+        return iSegmentRemap;
+    }
+
+    inline bool
+    ComScanReversed( ) const NOEXCEPT
+    {
+        return iComScanReversed;
+    }
+
+    inline bool
+    DisplayOn( ) const NOEXCEPT
+    {
+        return iDisplayOn;
+    }
+
+    inline std::uint8_t
+    ComPinsConfiguration( ) const NOEXCEPT
+    {
+        return iComPins;
+    }
+
+    inline bool
+    ChargePumpEnabled( ) const NOEXCEPT
+    {
+        return iChargePump;
+    }
+
+    inline bool
+    ScrollActive( ) const NOEXCEPT
+    {
+        return iScrollActive;
+    }
+
+private:
+    static constexpr std::uint8_t KControlContinuation = 0x80;
+    static constexpr std::uint8_t KControlData = 0x40;
+    static constexpr size_t KMaxCommandSize = 7;
+    static constexpr size_t KFirstSegment
+        = taDisplayType::KSegmentRemap
+              ? KRamColumns - TSsd1306Hal::KColumnOffset - TSsd1306Hal::KPixelWidth
+              : TSsd1306Hal::KColumnOffset;
+    // Start, address byte with its acknowledge and stop
+    static constexpr std::uint64_t KTransactionClocks = 1 + 9 + 1;
+    static constexpr std::uint64_t KByteClocks = 9;
+    // The frames per scroll step by the step interval code
+    static constexpr std::uint16_t KScrollStepFrames[] = { 5, 64, 128, 254, 3, 4, 25, 2 };
+
+    static constexpr size_t
+    CommandSize( std::uint8_t aCommand ) NOEXCEPT
+    {
+        switch ( aCommand )
+        {
+        case 0x20:  // Memory addressing mode
+        case 0x81:  // Contrast
+        case 0x8D:  // Charge pump
+        case 0xAD:  // DC-DC control (SH1106)
+        case 0xA8:  // Multiplex ratio
+        case 0xD3:  // Display offset
+        case 0xD5:  // Display clock
+        case 0xD9:  // Pre-charge period
+        case 0xDA:  // COM pins configuration
+        case 0xDB:  // VCOMH deselect level
+            return 2;
+        case 0x21:  // Column address
+        case 0x22:  // Page address
+        case 0xA3:  // Vertical scroll area
+            return 3;
+        case 0x29:  // Vertical and horizontal scroll
+        case 0x2A:
+            return 6;
+        case 0x26:  // Horizontal scroll
+        case 0x27:
+            return 7;
+        default:
+            return 1;
+        }
+    }
+
+    int
+    WriteSegments( std::uint8_t aAddress,
+                   const TTransferSegment* aSegments,
+                   size_t aSegmentsNumber,
+                   bool aNoStop ) NOEXCEPT
+    {
+        size_t length = 0;
+        for ( size_t i = 0; i < aSegmentsNumber; ++i )
+        {
+            length += aSegments[ i ].iSize;
+        }
+
+        if ( aAddress != iDeviceAddress || ( iMaxTransferSize != 0 && length > iMaxTransferSize ) )
+        {
+            AccountTransaction( 0, aNoStop );
+            ++iStatistics.iNacks;
+            return -1;
+        }
+
+        AccountTransaction( length, aNoStop );
+        const std::uint64_t dataBytes = iStatistics.iDataBytes;
+
+        // Co = 1: one byte follows, then the next control byte
+        // Co = 0: the rest of the transaction is of the same kind
+        bool controlExpected = true;
+        bool continuation = false;
+        bool data = false;
+        for ( size_t i = 0; i < aSegmentsNumber; ++i )
+        {
+            for ( size_t j = 0; j < aSegments[ i ].iSize; ++j )
+            {
+                const std::uint8_t byte = aSegments[ i ].iData[ j ];
+                if ( controlExpected )
+                {
+                    continuation = ( byte & KControlContinuation ) != 0;
+                    data = ( byte & KControlData ) != 0;
+                    controlExpected = false;
+                    continue;
+                }
+
+                if ( data )
+                {
+                    ++iStatistics.iDataBytes;
+                    WriteData( byte );
+                }
+                else
+                {
+                    ++iStatistics.iCommandBytes;
+                    WriteCommand( byte );
+                }
+                controlExpected = continuation;
+            }
+        }
+        iStatistics.iMaxTransactionDataBytes = std::max< std::uint32_t >(
+            iStatistics.iMaxTransactionDataBytes,
+            static_cast< std::uint32_t >( iStatistics.iDataBytes - dataBytes ) );
+        return static_cast< int >( length );
+    }
+
+    void
+    AccountTransaction( size_t aLength, bool aNoStop ) NOEXCEPT
+    {
+        ++iStatistics.iTransactions;
+        iStatistics.iWireBytes += 1u + aLength;
+        // A repeated start follows instead of the stop when the bus is kept
+        iStatistics.iBusClocks += KTransactionClocks + KByteClocks * aLength - ( aNoStop ? 1 : 0 );
+    }
+
+    void
+    WriteCommand( std::uint8_t aByte ) NOEXCEPT
+    {
+        if ( iPendingCommandSize == 0 )
+        {
+            iExpectedCommandSize = CommandSize( aByte );
+        }
+        iPendingCommand[ iPendingCommandSize++ ] = aByte;
+        if ( iPendingCommandSize == iExpectedCommandSize )
+        {
+            ExecuteCommand( );
+            iPendingCommandSize = 0;
+        }
+    }
+
+    void
+    ExecuteCommand( ) NOEXCEPT
+    {
+        const auto* command = iPendingCommand;
+        const std::uint8_t opcode = command[ 0 ];
+
+        if ( opcode <= 0x0F )
+        {
+            iColumn = static_cast< std::uint8_t >( ( iColumn & 0xF0 ) | opcode );
+            iPageModeColumnStart = iColumn;
+            return;
+        }
+        if ( opcode <= 0x1F )
+        {
+            iColumn = static_cast< std::uint8_t >( ( iColumn & 0x0F ) | ( opcode & 0x0F ) << 4 );
+            iPageModeColumnStart = iColumn;
+            return;
+        }
+        if ( opcode >= 0x40 && opcode <= 0x7F )
+        {
+            iStartLine = opcode & 0x3F;
+            return;
+        }
+        if ( opcode >= 0xB0 && opcode <= 0xB7 )
+        {
+            iPage = opcode & 0x07;
+            return;
+        }
+
+        switch ( opcode )
+        {
+        case 0x20:
+            if ( ( command[ 1 ] & 0x03 ) != 0x03 )
+            {
+                iMode = static_cast< TAddressingMode >( command[ 1 ] & 0x03 );
+            }
+            break;
+        case 0x21:
+            iColumnStart = command[ 1 ] & 0x7F;
+            iColumnEnd = command[ 2 ] & 0x7F;
+            iColumn = iColumnStart;
+            break;
+        case 0x22:
+            iPageStart = command[ 1 ] & 0x07;
+            iPageEnd = command[ 2 ] & 0x07;
+            iPage = iPageStart;
+            break;
+        case 0x26:
+        case 0x27:
+            iScrollLeft = opcode == 0x27;
+            iScrollStartPage = command[ 2 ] & 0x07;
+            iScrollEndPage = std::max< std::uint8_t >( iScrollStartPage, command[ 4 ] & 0x07 );
+            iScrollStepFrames = KScrollStepFrames[ command[ 3 ] & 0x07 ];
+            iScrollFrames = 0;
+            break;
+        case 0x29:
+        case 0x2A:
+        case 0xA3:
+            // The scroll setup is accepted but not emulated
+            iScrollStepFrames = 0;
+            break;
+        case 0x2E:
+            iScrollActive = false;
+            break;
+        case 0x2F:
+            iScrollActive = true;
+            break;
+        case 0x81:
+            iContrast = command[ 1 ];
+            break;
+        case 0x8D:
+            iChargePump = ( command[ 1 ] & 0x04 ) != 0;
+            break;
+        case 0xAD:
+            iChargePump = ( command[ 1 ] & 0x01 ) != 0;
+            break;
+        case 0x30:
+        case 0x31:
+        case 0x32:
+        case 0x33:
+            // Pump voltage (SH1106)
+            break;
+        case 0xA0:
+        case 0xA1:
+            iSegmentRemap = opcode == 0xA1;
+            break;
+        case 0xA4:
+        case 0xA5:
+            iEntireDisplayOn = opcode == 0xA5;
+            break;
+        case 0xA6:
+        case 0xA7:
+            iInverse = opcode == 0xA7;
+            break;
+        case 0xA8:
+            // The ratios below 16 are invalid and ignored
+            if ( ( command[ 1 ] & 0x3F ) >= 15 )
+            {
+                iMultiplexRatio = command[ 1 ] & 0x3F;
+            }
+            break;
+        case 0xAE:
+        case 0xAF:
+            iDisplayOn = opcode == 0xAF;
+            break;
+        case 0xC0:
+        case 0xC8:
+            iComScanReversed = opcode == 0xC8;
+            break;
+        case 0xD3:
+            iDisplayOffset = command[ 1 ] & 0x3F;
+            break;
+        case 0xDA:
+            iComPins = command[ 1 ];
+            break;
+        case 0xD5:
+        case 0xD9:
+        case 0xDB:
+        case 0xE3:
+            // Timing and analog settings, no effect on the image
+            break;
+        default:
+            ++iStatistics.iUnknownCommands;
+            break;
+        }
+    }
+
+    void
+    WriteData( std::uint8_t aByte ) NOEXCEPT
+    {
+        if ( iScrollActive )
+        {
+            ++iStatistics.iDataBytesWhileScrolling;
+        }
+        // The column pointer can be set past the RAM with the page mode commands
+        if ( iColumn < KRamColumns )
+        {
+            iRam[ iPage ][ iColumn ] = aByte;
+        }
+
+        switch ( iMode )
+        {
+        case TAddressingMode::Horizontal:
+            if ( iColumn != iColumnEnd )
+            {
+                ++iColumn;
+                break;
+            }
+            iColumn = iColumnStart;
+            iPage = iPage != iPageEnd ? static_cast< std::uint8_t >( iPage + 1 ) : iPageStart;
+            break;
+        case TAddressingMode::Vertical:
+            if ( iPage != iPageEnd )
+            {
+                ++iPage;
+                break;
+            }
+            iPage = iPageStart;
+            iColumn = iColumn != iColumnEnd ? static_cast< std::uint8_t >( iColumn + 1 )
+                                            : iColumnStart;
+            break;
+        case TAddressingMode::Page:
+            // The page pointer stays, the column pointer wraps within the page
+            iColumn = iColumn != KRamColumns - 1 ? static_cast< std::uint8_t >( iColumn + 1 )
+                                                 : iPageModeColumnStart;
+            break;
+        }
+    }
+
+    const std::uint8_t iDeviceAddress;
+    std::uint32_t iClock;
+    size_t iMaxTransferSize = 0;
+    TStatistics iStatistics{ };
+
+    std::uint8_t iRam[ KRamPages ][ KRamColumns ]{ };
+
+    TAddressingMode iMode;
+    std::uint8_t iColumnStart;
+    std::uint8_t iColumnEnd;
+    std::uint8_t iPageStart;
+    std::uint8_t iPageEnd;
+    std::uint8_t iPageModeColumnStart;
+    std::uint8_t iColumn;
+    std::uint8_t iPage;
+    std::uint8_t iStartLine;
+    std::uint8_t iDisplayOffset;
+    std::uint8_t iMultiplexRatio;
+    std::uint8_t iContrast;
+    std::uint8_t iComPins;
+    bool iSegmentRemap;
+    bool iComScanReversed;
+    bool iInverse;
+    bool iEntireDisplayOn;
+    bool iDisplayOn;
+    bool iChargePump;
+    bool iScrollActive;
+    bool iScrollLeft;
+    std::uint8_t iScrollStartPage;
+    std::uint8_t iScrollEndPage;
+    // 0 unless the horizontal scroll is set up
+    std::uint16_t iScrollStepFrames;
+    std::uint32_t iScrollFrames;
+
+    // A multi-byte command can span several control bytes and transactions
+    std::uint8_t iPendingCommand[ KMaxCommandSize ];
+    size_t iPendingCommandSize;
+    size_t iExpectedCommandSize;
+};
+}  // namespace Ssd1306
+}  // namespace ExternalHardware
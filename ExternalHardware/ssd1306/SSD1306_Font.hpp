@@ -0,0 +1,224 @@
+#pragma once
+#include <AbstractPlatform/common/Platform.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstddef>
+
+namespace ExternalHardware
+{
+namespace Ssd1306
+{
+/**
+ * @brief A glyph of the font. The glyph bitmap is stored in the SSD1306 page-major layout: the
+ * font iPages rows of iWidth column bytes, the LSB of a byte is the top pixel of the page. The
+ * rows cover the whole font height, so the glyphs of a line share the top edge.
+ */
+struct TGlyph
+{
+    // The offset of the glyph bitmap in the font bitmaps
+    std::uint32_t iBitmapOffset;
+    // The bitmap width in columns
+    std::uint8_t iWidth;
+    // The distance of the bitmap left edge from the pen position
+    std::int8_t iXOffset;
+    // The pen advance after the glyph
+    std::uint8_t iAdvance;
+};
+
+/**
+ * @brief The pen advance adjustment of a pair of the characters.
+ */
+struct TKerningPair
+{
+    std::uint8_t iLeft;
+    std::uint8_t iRight;
+    std::int8_t iAdjustment;
+};
+
+/**
+ * @brief A bitmap font in the page-major layout, generated by the font converter tool
+ * (tools/SSD1306_FontConverter.cpp) from a BDF font.
+ */
+struct TFont
+{
+    // The line height in pixels
+    std::uint8_t iHeight;
+    // The number of the page rows of the glyph bitmaps, ( iHeight + 7 ) / 8
+    std::uint8_t iPages;
+    // The baseline distance from the top edge
+    std::uint8_t iBaseline;
+    std::uint8_t iFirstCharacter;
+    std::uint8_t iLastCharacter;
+    // Drawn instead of the characters missing in the font
+    std::uint8_t iDefaultCharacter;
+    // One glyph per character from iFirstCharacter to iLastCharacter
+    const TGlyph* iGlyphs;
+    const std::uint8_t* iBitmaps;
+    // Sorted by the left and then the right character
+    const TKerningPair* iKerningPairs;
+    std::uint16_t iKerningPairsCount;
+};
+
+/**
+ * @brief The text bounding box in the render area coordinates.
+ */
+struct TTextBounds
+{
+    int iX;
+    int iY;
+    int iWidth;
+    int iHeight;
+};
+
+/**
+ * @brief Draws the text of the page-major fonts into the render areas. The glyph bitmaps are
+ * blitted by CRenderAreaBase::DrawPageBitmap(), which copies whole column bytes at the page
+ * aligned positions and shifts two pages together elsewhere, and marks the text box dirty, so
+ * the next Render() sends only the text.
+ */
+class CTextRenderer
+{
+public:
+    /**
+     * @brief The glyph of the character, the default glyph for the characters missing in the
+     * font.
+     */
+    static const TGlyph&
+    Glyph( const TFont& aFont, std::uint8_t aCharacter ) NOEXCEPT
+    {
+        if ( aCharacter < aFont.iFirstCharacter || aCharacter > aFont.iLastCharacter )
+        {
+            aCharacter = aFont.iDefaultCharacter;
+        }
+        return aFont.iGlyphs[ aCharacter - aFont.iFirstCharacter ];
+    }
+
+    /**
+     * @brief The pen advance adjustment between two characters.
+     */
+    static int
+    Kerning( const TFont& aFont, std::uint8_t aLeft, std::uint8_t aRight ) NOEXCEPT
+    {
+        size_t begin = 0;
+        size_t end = aFont.iKerningPairsCount;
+        const std::uint16_t key = static_cast< std::uint16_t >( aLeft << 8 | aRight );
+        while ( begin < end )
+        {
+            const size_t middle = ( begin + end ) / 2;
+            const auto& pair = aFont.iKerningPairs[ middle ];
+            const std::uint16_t pairKey = static_cast< std::uint16_t >( pair.iLeft << 8
+                                                                        | pair.iRight );
+            if ( pairKey == key )
+            {
+                return pair.iAdjustment;
+            }
+            if ( pairKey < key )
+            {
+                begin = middle + 1;
+            }
+            else
+            {
+                end = middle;
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * @brief The advance width of the text in pixels.
+     */
+    static int
+    TextWidth( const TFont& aFont, const char* aText ) NOEXCEPT
+    {
+        assert( aText != nullptr );
+
+        int width = 0;
+        for ( const char* character = aText; *character != '\0'; ++character )
+        {
+            const auto current = static_cast< std::uint8_t >( *character );
+            width += Glyph( aFont, current ).iAdvance;
+            if ( character[ 1 ] != '\0' )
+            {
+                width += Kerning( aFont, current, static_cast< std::uint8_t >( character[ 1 ] ) );
+            }
+        }
+        return width;
+    }
+
+    /**
+     * @brief Draws the text with its top left corner at the given position.
+     *
+     * @param aRenderArea The render area to draw into, a CRenderAreaBase of any display
+     * @param aFont The font
+     * @param aX The render area column of the text left edge
+     * @param aY The render area row of the text top edge
+     * @param aText The zero terminated text
+     * @param aOpaque Clear the text box background, otherwise only the set glyph pixels are
+     * drawn. The glyphs drawn over the previous ones due to the negative kerning are merged.
+     * @return TTextBounds The box covered by the text, unclipped
+     */
+    template < typename taRenderArea >
+    static TTextBounds
+    DrawText( taRenderArea& aRenderArea,
+              const TFont& aFont,
+              int aX,
+              int aY,
+              const char* aText,
+              bool aOpaque = true ) NOEXCEPT
+    {
+        using TPixel = typename taRenderArea::TPixel;
+
+        assert( aText != nullptr );
+        assert( aFont.iPages == ( aFont.iHeight + 7 ) / 8 );
+
+        int pen = aX;
+        // The right edge of the drawn columns
+        int drawnEnd = aX;
+        for ( const char* character = aText; *character != '\0'; ++character )
+        {
+            const auto current = static_cast< std::uint8_t >( *character );
+            const auto& glyph = Glyph( aFont, current );
+            const int left = pen + glyph.iXOffset;
+            const auto* bitmap = aFont.iBitmaps + glyph.iBitmapOffset;
+
+            if ( !aOpaque || left >= drawnEnd )
+            {
+                if ( aOpaque && left > drawnEnd )
+                {
+                    aRenderArea.FillRectangle( drawnEnd, aY, left - drawnEnd, aFont.iHeight,
+                                               TPixel{ false } );
+                }
+                aRenderArea.DrawPageBitmap( left, aY, glyph.iWidth, aFont.iHeight, bitmap,
+                                            glyph.iWidth, !aOpaque );
+            }
+            else
+            {
+                // Merge the columns overlapping the previous glyphs, copy the rest
+                const int overlap = std::min< int >( drawnEnd - left, glyph.iWidth );
+                aRenderArea.DrawPageBitmap( left, aY, overlap, aFont.iHeight, bitmap,
+                                            glyph.iWidth, true );
+                aRenderArea.DrawPageBitmap( left + overlap, aY, glyph.iWidth - overlap,
+                                            aFont.iHeight, bitmap + overlap, glyph.iWidth );
+            }
+            drawnEnd = std::max( drawnEnd, left + glyph.iWidth );
+
+            pen += glyph.iAdvance;
+            if ( character[ 1 ] != '\0' )
+            {
+                pen += Kerning( aFont, current, static_cast< std::uint8_t >( character[ 1 ] ) );
+            }
+        }
+
+        if ( aOpaque && pen > drawnEnd )
+        {
+            aRenderArea.FillRectangle( drawnEnd, aY, pen - drawnEnd, aFont.iHeight,
+                                       TPixel{ false } );
+            drawnEnd = pen;
+        }
+        return TTextBounds{ aX, aY, std::max( drawnEnd, pen ) - aX, aFont.iHeight };
+    }
+};
+}  // namespace Ssd1306
+}  // namespace ExternalHardware
@@ -0,0 +1,231 @@
+#pragma once
+#include <AbstractPlatform/common/Platform.hpp>
+#include <ExternalHardware/ssd1306/SSD1306.hpp>
+
+#include <cassert>
+#include <cstdint>
+
+namespace ExternalHardware
+{
+namespace Ssd1306
+{
+/**
+ * @brief Coalesces the frame ready notifications of the application and renders at most at the
+ * target frame rate and within the bus utilisation budget. The render areas are sent at the
+ * next free slot with their content at that time, so the latest content is always shown and
+ * the intermediate frames cost nothing on the bus.
+ *
+ * A notification for an area already waiting for the slot drops the previous frame of the
+ * area (it is never shown); a notification for another area merges it into the same slot.
+ *
+ * @tparam taDisplayType The display type
+ * @tparam taRenderer The renderer, CSsd1306 or any other providing
+ * TErrorCode Render( const CRenderAreaBase&, size_t* aSkippedBytes )
+ * @tparam taMaxAreas The maximum number of the render areas waiting for a slot
+ */
+template < typename taDisplayType = Ssd1306128x32,
+           typename taRenderer = CSsd1306< taDisplayType >,
+           size_t taMaxAreas = 4 >
+class CSsd1306FrameGovernor
+{
+public:
+    using TSsd1306 = CSsd1306< taDisplayType >;
+    using TRenderArea = typename TSsd1306::CRenderAreaBase;
+
+    static constexpr std::uint32_t KMicrosecondsPerSecond = 1000000;
+
+    struct TBudget
+    {
+        // The maximum number of the slots per second
+        std::uint32_t iTargetFps;
+        // The maximum share of the time the renders may keep the bus busy, in percent
+        std::uint8_t iBusUtilization;
+    };
+
+    struct TStatistics
+    {
+        std::uint32_t iNotifications;
+        // The slots the pending areas have been rendered in
+        std::uint32_t iFrames;
+        // The notifications merged into a slot with the other areas
+        std::uint32_t iMergedFrames;
+        // The frames replaced by a newer frame of the same area before their slot
+        std::uint32_t iDroppedFrames;
+        // The renders of the areas failed with a bus error, retried in the next slot
+        std::uint32_t iRenderErrors;
+        std::uint64_t iSentBytes;
+        // The time spent in the renders
+        std::uint64_t iBusyTime;
+    };
+
+    /**
+     * @brief Construct a new frame governor
+     *
+     * @param aRenderer The renderer of the display
+     * @param aClock The microsecond clock
+     * @param aBudget The frame rate and the bus utilisation caps
+     */
+    CSsd1306FrameGovernor( taRenderer& aRenderer,
+                           TClock aClock,
+                           TBudget aBudget = TBudget{ 30, 100 } ) NOEXCEPT
+        : iRenderer{ aRenderer }
+        , iClock{ aClock }
+        , iPendingAreas{ }
+        , iPendingSize{ 0 }
+        , iNextSlot{ 0 }
+        , iStatistics{ }
+        , iWindowStart{ 0 }
+        , iWindowFrames{ 0 }
+        , iAchievedFps{ 0 }
+    {
+        assert( aClock != nullptr );
+        SetBudget( aBudget );
+        iNextSlot = iClock( );
+        iWindowStart = iNextSlot;
+    }
+
+    inline void
+    SetBudget( TBudget aBudget ) NOEXCEPT
+    {
+        assert( aBudget.iTargetFps != 0 );
+        assert( aBudget.iBusUtilization != 0 && aBudget.iBusUtilization <= 100 );
+        iBudget = aBudget;
+    }
+
+    /**
+     * @brief Notifies the governor that a new frame has been drawn in the render area.
+     *
+     * @return true if the area is waiting for the slot, false if there is no room for it
+     */
+    bool
+    FrameReady( const TRenderArea& aRenderArea ) NOEXCEPT
+    {
+        ++iStatistics.iNotifications;
+        for ( size_t i = 0; i < iPendingSize; ++i )
+        {
+            if ( iPendingAreas[ i ] == &aRenderArea )
+            {
+                ++iStatistics.iDroppedFrames;
+                return true;
+            }
+        }
+
+        if ( iPendingSize == taMaxAreas )
+        {
+            return false;
+        }
+        if ( iPendingSize != 0 )
+        {
+            ++iStatistics.iMergedFrames;
+        }
+        iPendingAreas[ iPendingSize++ ] = &aRenderArea;
+        return true;
+    }
+
+    /**
+     * @brief Renders the pending areas if their slot has come.
+     *
+     * @return true if a slot has been rendered, false otherwise
+     */
+    bool
+    Poll( ) NOEXCEPT
+    {
+        const auto now = iClock( );
+        UpdateAchievedFps( now );
+
+        // The distance comparison survives the clock wrap-around
+        if ( iPendingSize == 0 || static_cast< std::int32_t >( now - iNextSlot ) < 0 )
+        {
+            return false;
+        }
+
+        // The areas failed to render stay pending for the next slot
+        size_t failed = 0;
+        for ( size_t i = 0; i < iPendingSize; ++i )
+        {
+            const auto& renderArea = *iPendingAreas[ i ];
+            size_t skippedBytes = 0;
+            if ( iRenderer.Render( renderArea, &skippedBytes ) != AbstractPlatform::KOk )
+            {
+                ++iStatistics.iRenderErrors;
+                iPendingAreas[ failed++ ] = &renderArea;
+                continue;
+            }
+            iStatistics.iSentBytes += renderArea.GetDisplayBufferSize( ) - skippedBytes;
+        }
+        iPendingSize = failed;
+
+        const auto end = iClock( );
+        const std::uint32_t busyTime = end - now;
+        iStatistics.iBusyTime += busyTime;
+        ++iStatistics.iFrames;
+        ++iWindowFrames;
+
+        // The next slot is not earlier than the frame period after this one and leaves the bus
+        // idle long enough for the utilisation budget
+        const std::uint32_t framePeriod = KMicrosecondsPerSecond / iBudget.iTargetFps;
+        const std::uint32_t idleTime = static_cast< std::uint32_t >(
+            static_cast< std::uint64_t >( busyTime ) * ( 100u - iBudget.iBusUtilization )
+            / iBudget.iBusUtilization );
+        const std::uint32_t budgetSlot = end + idleTime;
+        const std::uint32_t rateSlot = now + framePeriod;
+        iNextSlot = static_cast< std::int32_t >( budgetSlot - rateSlot ) > 0 ? budgetSlot
+                                                                              : rateSlot;
+        return true;
+    }
+
+    inline bool
+    Pending( ) const NOEXCEPT
+    {
+        return iPendingSize != 0;
+    }
+
+    inline const TStatistics&
+    Statistics( ) const NOEXCEPT
+    {
+        return iStatistics;
+    }
+
+    inline void
+    ResetStatistics( ) NOEXCEPT
+    {
+        iStatistics = TStatistics{ };
+    }
+
+    /**
+     * @brief The number of the slots rendered within the last complete second.
+     */
+    inline std::uint32_t
+    AchievedFps( ) const NOEXCEPT
+    {
+        return iAchievedFps;
+    }
+
+private:
+    void
+    UpdateAchievedFps( std::uint32_t aNow ) NOEXCEPT
+    {
+        const std::uint32_t elapsed = aNow - iWindowStart;
+        if ( elapsed < KMicrosecondsPerSecond )
+        {
+            return;
+        }
+        iAchievedFps = static_cast< std::uint32_t >(
+            static_cast< std::uint64_t >( iWindowFrames ) * KMicrosecondsPerSecond / elapsed );
+        iWindowStart = aNow;
+        iWindowFrames = 0;
+    }
+
+    taRenderer& iRenderer;
+    const TClock iClock;
+    TBudget iBudget;
+    const TRenderArea* iPendingAreas[ taMaxAreas ];
+    size_t iPendingSize;
+    std::uint32_t iNextSlot;
+    TStatistics iStatistics;
+    std::uint32_t iWindowStart;
+    std::uint32_t iWindowFrames;
+    std::uint32_t iAchievedFps;
+};
+}  // namespace Ssd1306
+}  // namespace ExternalHardware
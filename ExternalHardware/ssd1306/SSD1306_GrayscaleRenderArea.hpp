@@ -0,0 +1,277 @@
+#pragma once
+#include <AbstractPlatform/common/Platform.hpp>
+#include <ExternalHardware/ssd1306/SSD1306.hpp>
+#include <ExternalHardware/ssd1306/SSD1306_DiffRenderer.hpp>
+
+#include <cassert>
+#include <cstdint>
+
+namespace ExternalHardware
+{
+namespace Ssd1306
+{
+/**
+ * @brief Render area with 2 or 4 bits per pixel shown by temporal dithering. The gray levels
+ * are kept as bit-planes, each a 1bpp render area, and the display cycles through them: with
+ * the temporal modulation the plane of bit k is shown for 2^k of the 2^b - 1 subframes of a
+ * cycle, with the contrast modulation every plane is shown once per cycle at a contrast
+ * weighted by 2^k, which costs 2 more command bytes per subframe but needs only b subframes.
+ *
+ * The subframes are sent by the diff renderer, so the pixels which are equal in the successive
+ * planes (black, white and the flat areas) cost no bus time; only the pixels with intermediate
+ * gray levels are rewritten. The shown level is perceived correctly only when the cycles are
+ * fast enough not to flicker, typically 60 cycles per second or more.
+ *
+ * The contrast modulation relies on the panel luminance being roughly proportional to the
+ * contrast setting, which holds only approximately. The display contrast is left changed after
+ * a contrast modulated subframe, set it again when leaving the grayscale mode.
+ *
+ * @tparam taDisplayType The display type
+ * @tparam taBitsPerPixel The bits per pixel, 2 or 4
+ * @tparam taBeginColumn The first display column covered by the area
+ * @tparam taLastColumn The last display column covered by the area
+ * @tparam taBeginPage The first display page covered by the area
+ * @tparam taLastPage The last display page covered by the area
+ */
+template < typename taDisplayType = Ssd1306128x32,
+           std::uint8_t taBitsPerPixel = 2,
+           std::uint8_t taBeginColumn = 0,
+           std::uint8_t taLastColumn = CSsd1306Hal< taDisplayType >::KMaxColumns - 1,
+           std::uint8_t taBeginPage = 0,
+           std::uint8_t taLastPage = CSsd1306Hal< taDisplayType >::KMaxPages - 1 >
+class CSsd1306GrayscaleRenderArea
+{
+    static_assert( taBitsPerPixel == 2 || taBitsPerPixel == 4, "Unsupported bits per pixel" );
+
+public:
+    using TSsd1306 = CSsd1306< taDisplayType >;
+    using TPlane = typename TSsd1306::
+        template CStaticRenderArea< taBeginColumn, taLastColumn, taBeginPage, taLastPage >;
+    using TDiffRenderer = CSsd1306DiffRenderer< taDisplayType >;
+    using TPixel = typename TPlane::TPixel;
+    using TErrorCode = AbstractPlatform::TErrorCode;
+
+    enum class TModulation : std::uint8_t
+    {
+        Temporal,
+        Contrast
+    };
+
+    static constexpr std::uint8_t KMaxLevel = ( 1u << taBitsPerPixel ) - 1;
+
+    /**
+     * @brief Construct a new grayscale render area, all the pixels are black.
+     *
+     * @param aModulation The way the bit-planes are weighted
+     * @param aMaxContrast The contrast of the most significant plane with the contrast
+     * modulation, also set by the temporal modulation on its first subframe
+     */
+    explicit CSsd1306GrayscaleRenderArea( TModulation aModulation = TModulation::Temporal,
+                                          std::uint8_t aMaxContrast = 0xFF ) NOEXCEPT
+        : iModulation{ aModulation }
+        , iMaxContrast{ aMaxContrast }
+        , iSubframe{ 0 }
+        , iContrastSet{ false }
+    {
+    }
+
+    CSsd1306GrayscaleRenderArea( const CSsd1306GrayscaleRenderArea& ) = delete;
+    CSsd1306GrayscaleRenderArea& operator=( const CSsd1306GrayscaleRenderArea& ) = delete;
+
+    inline int
+    PixelWidth( ) const NOEXCEPT
+    {
+        return iPlanes[ 0 ].PixelWidth( );
+    }
+
+    inline int
+    PixelHeight( ) const NOEXCEPT
+    {
+        return iPlanes[ 0 ].PixelHeight( );
+    }
+
+    void
+    SetGray( int aX, int aY, std::uint8_t aLevel ) NOEXCEPT
+    {
+        assert( aLevel <= KMaxLevel );
+        for ( std::uint8_t bit = 0; bit < taBitsPerPixel; ++bit )
+        {
+            auto& plane = iPlanes[ bit ];
+            plane.SetPosition( aX, aY );
+            plane.SetPixel( TPixel{ ( ( aLevel >> bit ) & 1u ) != 0 } );
+        }
+    }
+
+    std::uint8_t
+    GetGray( int aX, int aY ) NOEXCEPT
+    {
+        std::uint8_t level = 0;
+        for ( std::uint8_t bit = 0; bit < taBitsPerPixel; ++bit )
+        {
+            auto& plane = iPlanes[ bit ];
+            plane.SetPosition( aX, aY );
+            level |= static_cast< std::uint8_t >( plane.GetPixel( ).iPixelValue << bit );
+        }
+        return level;
+    }
+
+    void
+    FillRectangle( int aX, int aY, int aWidth, int aHeight, std::uint8_t aLevel ) NOEXCEPT
+    {
+        assert( aLevel <= KMaxLevel );
+        for ( std::uint8_t bit = 0; bit < taBitsPerPixel; ++bit )
+        {
+            iPlanes[ bit ].FillRectangle( aX, aY, aWidth, aHeight,
+                                          TPixel{ ( ( aLevel >> bit ) & 1u ) != 0 } );
+        }
+    }
+
+    void
+    FillWith( std::uint8_t aLevel = 0 ) NOEXCEPT
+    {
+        assert( aLevel <= KMaxLevel );
+        for ( std::uint8_t bit = 0; bit < taBitsPerPixel; ++bit )
+        {
+            iPlanes[ bit ].FillWith( TPixel{ ( ( aLevel >> bit ) & 1u ) != 0 } );
+        }
+    }
+
+    /**
+     * @brief Draws the row-major bitmap with one gray level per byte at the given position.
+     * The levels above KMaxLevel are not allowed, scale the source down beforehand.
+     *
+     * @param aX The render area column of the bitmap left edge
+     * @param aY The render area row of the bitmap top edge
+     * @param aWidth The bitmap width in pixels
+     * @param aHeight The bitmap height in pixels
+     * @param aBitmap The bitmap data
+     * @param aStride The distance between the bitmap rows in bytes
+     */
+    void
+    DrawGrayBitmap( int aX,
+                    int aY,
+                    int aWidth,
+                    int aHeight,
+                    const std::uint8_t* aBitmap,
+                    size_t aStride ) NOEXCEPT
+    {
+        assert( aBitmap != nullptr );
+        assert( aStride >= static_cast< size_t >( aWidth ) );
+
+        for ( int y = 0; y < aHeight; ++y )
+        {
+            const int row = aY + y;
+            if ( row < 0 || row >= PixelHeight( ) )
+            {
+                continue;
+            }
+            for ( int x = 0; x < aWidth; ++x )
+            {
+                const int column = aX + x;
+                if ( column >= 0 && column < PixelWidth( ) )
+                {
+                    SetGray( column, row, aBitmap[ y * aStride + x ] );
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief The bit-plane of the given bit of the gray levels.
+     */
+    inline const TPlane&
+    Plane( std::uint8_t aBit ) const NOEXCEPT
+    {
+        assert( aBit < taBitsPerPixel );
+        return iPlanes[ aBit ];
+    }
+
+    inline TModulation
+    Modulation( ) const NOEXCEPT
+    {
+        return iModulation;
+    }
+
+    /**
+     * @brief Switches the modulation, the new one starts with a new cycle.
+     */
+    inline void
+    SetModulation( TModulation aModulation ) NOEXCEPT
+    {
+        iModulation = aModulation;
+        iSubframe = 0;
+        iContrastSet = false;
+    }
+
+    /**
+     * @brief The number of the subframes one gray cycle takes. The subframe rate needed for the
+     * cycle rate F is F * SubframesPerCycle().
+     */
+    constexpr size_t
+    SubframesPerCycle( ) const NOEXCEPT
+    {
+        return iModulation == TModulation::Temporal ? KMaxLevel : taBitsPerPixel;
+    }
+
+    /**
+     * @brief Sends the next subframe of the cycle. Call it at a steady rate.
+     *
+     * @param aRenderer The diff renderer of the display, which shouldn't render other areas
+     * overlapping this one in between
+     * @param aSkippedBytes Receives the number of the plane bytes skipped as unchanged
+     * @return TErrorCode AbstractPlatform::KOk on success, otherwise the bus error. The failed
+     * subframe is sent again by the next call.
+     */
+    TErrorCode
+    RenderSubframe( TDiffRenderer& aRenderer, size_t* aSkippedBytes = nullptr ) NOEXCEPT
+    {
+        using namespace AbstractPlatform;
+
+        const auto bit = PlaneOf( iSubframe );
+        if ( iModulation == TModulation::Contrast )
+        {
+            RETURN_ON_ERROR( aRenderer.Display( ).Hal( ).SetContrast(
+                static_cast< std::uint8_t >( iMaxContrast >> ( taBitsPerPixel - 1 - bit ) ) ) );
+        }
+        else if ( !iContrastSet )
+        {
+            RETURN_ON_ERROR( aRenderer.Display( ).Hal( ).SetContrast( iMaxContrast ) );
+            iContrastSet = true;
+        }
+
+        RETURN_ON_ERROR( aRenderer.Render( iPlanes[ bit ], aSkippedBytes ) );
+        iSubframe = static_cast< std::uint8_t >( ( iSubframe + 1 ) % SubframesPerCycle( ) );
+        return KOk;
+    }
+
+private:
+    /**
+     * @brief The plane shown in the subframe. The temporal modulation spreads the subframes of
+     * each plane evenly over the cycle: the subframe i shows the plane b - 1 - ctz( i + 1 ), so
+     * the most significant plane takes every other subframe.
+     */
+    constexpr std::uint8_t
+    PlaneOf( std::uint8_t aSubframe ) const NOEXCEPT
+    {
+        if ( iModulation == TModulation::Contrast )
+        {
+            return aSubframe;
+        }
+
+        std::uint8_t trailingZeros = 0;
+        for ( unsigned i = aSubframe + 1u; ( i & 1u ) == 0; i >>= 1 )
+        {
+            ++trailingZeros;
+        }
+        return static_cast< std::uint8_t >( taBitsPerPixel - 1 - trailingZeros );
+    }
+
+    TPlane iPlanes[ taBitsPerPixel ];
+    TModulation iModulation;
+    std::uint8_t iMaxContrast;
+    std::uint8_t iSubframe;
+    // Whether the temporal modulation has set the maximum contrast
+    bool iContrastSet;
+};
+}  // namespace Ssd1306
+}  // namespace ExternalHardware
@@ -4,11 +4,14 @@
 #include <AbstractPlatform/common/ErrorCode.hpp>
 #include <AbstractPlatform/common/ArrayHelper.hpp>
 #include <AbstractPlatform/i2c/AbstractI2C.hpp>
+#include <ExternalHardware/ssd1306/SSD1306_Instrumentation.hpp>
+#include <ExternalHardware/ssd1306/SSD1306_Transfer.hpp>
+#include <ExternalHardware/ssd1306/SSD1306_I2CTransport.hpp>
 
 #include <cstdio>
 #include <cstdint>
 #include <cstring>
-#include <vector>
+#include <algorithm>
 #include <cassert>
 
 namespace ExternalHardware
@@ -16,28 +19,107 @@ namespace ExternalHardware
 namespace Ssd1306
 {
 
-struct Ssd1306128x32
+enum class TDisplayController
+{
+    Ssd1306,
+    // SH1106: 132 column RAM, page addressing mode only
+    Sh1106
+};
+
+/**
+ * @brief The power-on settings shared by the SSD1306 modules. A display type inherits them and
+ * overrides the ones its module is wired differently for, the init sequence is built from them.
+ * The transport is the bus interface of the module, see TSpiDisplay for the SPI modules.
+ */
+struct TSsd1306PanelTraits
+{
+    using TTransport = CSsd1306I2CTransport;
+    static constexpr TDisplayController KController = TDisplayController::Ssd1306;
+    // The controller RAM width and the RAM column shown as the first panel column
+    static constexpr std::uint8_t KRamColumns = 128;
+    static constexpr std::uint8_t KColumnOffset = 0;
+    static constexpr bool KSegmentRemap = true;
+    static constexpr bool KCOMScanReversed = true;
+    static constexpr std::uint8_t KDisplayOffset = 0;
+    // Board specific: 0x02 sequential COM pins, 0x12 alternative ones, +0x20 left/right remap
+    static constexpr std::uint8_t KCOMPinsConfiguration = 0x12;
+    static constexpr std::uint8_t KDisplayClock = 0x80;     // Oscillator 8, divide ratio 1
+    static constexpr std::uint8_t KPreChargePeriod = 0xF1;  // Phase 1: 1 DCLK, phase 2: 15 DCLK
+    static constexpr std::uint8_t KVCOMHDeselectLevel = 0x30;  // 0.83 Vcc
+    static constexpr std::uint8_t KContrast = 0xFF;
+    static constexpr bool KChargePump = true;
+};
+
+struct Ssd1306128x32 : TSsd1306PanelTraits
 {
     using TPage = std::uint8_t;
     static constexpr std::uint8_t KPixelWidth = 128;
     static constexpr std::uint8_t KPixelHight = 32;
     static constexpr std::uint8_t KPixelsPerPage = 8;
+    static constexpr std::uint8_t KCOMPinsConfiguration = 0x02;
+};
+
+struct Ssd1306128x64 : TSsd1306PanelTraits
+{
+    using TPage = std::uint8_t;
+    static constexpr std::uint8_t KPixelWidth = 128;
+    static constexpr std::uint8_t KPixelHight = 64;
+    static constexpr std::uint8_t KPixelsPerPage = 8;
+};
+
+struct Ssd130696x16 : TSsd1306PanelTraits
+{
+    using TPage = std::uint8_t;
+    static constexpr std::uint8_t KPixelWidth = 96;
+    static constexpr std::uint8_t KPixelHight = 16;
+    static constexpr std::uint8_t KPixelsPerPage = 8;
+    static constexpr std::uint8_t KCOMPinsConfiguration = 0x02;
 };
 
-struct Ssd1306128x64
+struct Ssd130672x40 : TSsd1306PanelTraits
 {
     using TPage = std::uint8_t;
+    static constexpr std::uint8_t KPixelWidth = 72;
+    static constexpr std::uint8_t KPixelHight = 40;
+    static constexpr std::uint8_t KPixelsPerPage = 8;
+    static constexpr std::uint8_t KColumnOffset = 28;
+};
+
+struct Ssd130664x48 : TSsd1306PanelTraits
+{
+    using TPage = std::uint8_t;
+    static constexpr std::uint8_t KPixelWidth = 64;
+    static constexpr std::uint8_t KPixelHight = 48;
+    static constexpr std::uint8_t KPixelsPerPage = 8;
+    static constexpr std::uint8_t KColumnOffset = 32;
+};
+
+struct Sh1106128x64 : TSsd1306PanelTraits
+{
+    using TPage = std::uint8_t;
+    static constexpr TDisplayController KController = TDisplayController::Sh1106;
+    static constexpr std::uint8_t KRamColumns = 132;
+    static constexpr std::uint8_t KColumnOffset = 2;
     static constexpr std::uint8_t KPixelWidth = 128;
     static constexpr std::uint8_t KPixelHight = 64;
     static constexpr std::uint8_t KPixelsPerPage = 8;
 };
 
-template < typename taDisplayType = Ssd1306128x32 >
+/**
+ * @brief The controller commands and the RAM data transfers of the display.
+ *
+ * @tparam taDisplayType The display type
+ * @tparam taTransport The transport policy writing the commands and the data to the bus, see
+ * CSsd1306I2CTransport
+ */
+template < typename taDisplayType = Ssd1306128x32,
+           typename taTransport = typename taDisplayType::TTransport >
 class CSsd1306HalBase
 {
 public:
     using TErrorCode = AbstractPlatform::TErrorCode;
     using TPage = typename taDisplayType::TPage;
+    using TTransport = taTransport;
 
     static constexpr std::uint8_t KDefaultAddress = 0x3C;      // SA0 pulled to GND
     static constexpr std::uint8_t KAlternativeAddress = 0x3D;  // SA0 pulled to VS
@@ -45,20 +127,175 @@ public:
     static constexpr std::uint8_t KPixelHight = taDisplayType::KPixelHight;
     static constexpr std::uint8_t KPixelsPerPage = taDisplayType::KPixelsPerPage;
     static constexpr std::uint8_t KMaxColumns = taDisplayType::KPixelWidth;
-    static constexpr std::uint8_t KMaxPages
-        = static_cast< std::uint8_t >( ( taDisplayType::KPixelHight + 1 ) / KPixelsPerPage );
+    static constexpr std::uint8_t KMaxPages = static_cast< std::uint8_t >(
+        ( taDisplayType::KPixelHight + KPixelsPerPage - 1 ) / KPixelsPerPage );
+    // The visible part of the RAM, the rest of it is never sent by the driver
     static constexpr size_t KRamSize = KMaxColumns * KMaxPages * KPixelsPerPage / 8;
+    static constexpr std::uint8_t KRamColumns = taDisplayType::KRamColumns;
+    static constexpr std::uint8_t KRamPages = 8;
+    static constexpr std::uint8_t KColumnOffset = taDisplayType::KColumnOffset;
+    static constexpr TDisplayController KController = taDisplayType::KController;
+    // The controller has no horizontal addressing mode, the RAM address windows are emulated by
+    // the driver setting the page and column pointers for every page row sent
+    static constexpr bool KPageAddressingOnly = KController == TDisplayController::Sh1106;
     static constexpr std::uint8_t KCmdSetRamBuffer = 0x40;
+    // Co = 0, D/C = 0 => all the following bytes of the transaction are commands
+    static constexpr std::uint8_t KCmdStreamControlByte = 0x00;
+    // The control bytes opening the data and the command stream transactions, none on the
+    // transports telling the commands from the data by the D/C line
+    static constexpr size_t KDataHeaderSize
+        = taTransport::KControlBytes ? sizeof( KCmdSetRamBuffer ) : 0;
+    static constexpr size_t KCommandHeaderSize
+        = taTransport::KControlBytes ? sizeof( KCmdStreamControlByte ) : 0;
+    // The control byte and 31 commands fit the 32 byte transfer limit of the most MCU I2C stacks
+    static constexpr size_t KCommandStreamCapacity = 31;
+
+    /**
+     * @brief Collects the commands issued through the HAL setters into a fixed-size stack buffer
+     * and sends them as a single command stream transaction (control byte 0x00 followed by N
+     * command bytes, just the commands on the D/C line transports). While the stream object is
+     * alive all the HAL commands are appended to it instead of being sent one by one. The
+     * pending commands are flushed automatically when the buffer is full, before any RAM data
+     * is sent and on the stream destruction.
+     *
+     * @note The destructor can't report an error, so call Flush() explicitly to get the result.
+     * A stream created while another one is active just appends to the outer one.
+     */
+    class CCommandStream
+    {
+    public:
+        explicit CCommandStream( CSsd1306HalBase& aHal ) NOEXCEPT
+            : iHal{ aHal }
+            , iOuterStream{ aHal.iCommandStream }
+            , iSize{ 0 }
+            , iResult{ AbstractPlatform::KOk }
+        {
+            if ( KCommandHeaderSize != 0 )
+            {
+                iBuffer[ 0 ] = KCmdStreamControlByte;
+            }
+            if ( iOuterStream == nullptr )
+            {
+                iHal.iCommandStream = this;
+            }
+        }
+
+        CCommandStream( const CCommandStream& ) = delete;
+        CCommandStream& operator=( const CCommandStream& ) = delete;
+
+        ~CCommandStream( )
+        {
+            if ( iOuterStream == nullptr )
+            {
+                Flush( );
+                iHal.iCommandStream = nullptr;
+            }
+        }
+
+        /**
+         * @brief Sends all the pending commands in one bus transaction.
+         *
+         * @return TErrorCode KOk if all the commands of the stream have been sent successfully,
+         * otherwise the first error occurred.
+         */
+        TErrorCode
+        Flush( ) NOEXCEPT
+        {
+            if ( iOuterStream != nullptr )
+            {
+                return iOuterStream->Flush( );
+            }
+
+            if ( iSize != 0 )
+            {
+                const auto result = iHal.WriteCommandStream( iBuffer, KCommandHeaderSize + iSize );
+                iSize = 0;
+                if ( iResult == AbstractPlatform::KOk )
+                {
+                    iResult = result;
+                }
+            }
+            return iResult;
+        }
+
+    private:
+        friend class CSsd1306HalBase;
+
+        TErrorCode
+        Append( const std::uint8_t* aCommands, size_t aCommandsNumber ) NOEXCEPT
+        {
+            assert( iOuterStream == nullptr );
+
+            const size_t capacity = std::min(
+                KCommandStreamCapacity, iHal.iTransferPlanner.MaxChunkSize( KCommandHeaderSize ) );
+            for ( size_t i = 0; i < aCommandsNumber; ++i )
+            {
+                if ( iSize == capacity )
+                {
+                    RETURN_ON_ERROR( Flush( ) );
+                }
+                iBuffer[ KCommandHeaderSize + iSize++ ] = aCommands[ i ];
+            }
+            return AbstractPlatform::KOk;
+        }
+
+        CSsd1306HalBase& iHal;
+        CCommandStream* const iOuterStream;
+        size_t iSize;
+        TErrorCode iResult;
+        std::uint8_t iBuffer[ KCommandHeaderSize + KCommandStreamCapacity ];
+    };
 
     CSsd1306HalBase( AbstractPlatform::IAbstractI2CBus& aI2CBus,
                      std::uint8_t aDeviceAddress = KDefaultAddress ) NOEXCEPT
-        : iI2CBus{ aI2CBus },
-          iDeviceAddress{ aDeviceAddress }
+        : iTransport{ aI2CBus, aDeviceAddress }
+    {
+    }
+
+    /**
+     * @brief Construct the HAL on the bus able to gather a transaction from several buffers,
+     * the RAM data is then sent without being copied or touched.
+     */
+    CSsd1306HalBase( IScatterGatherI2CBus& aI2CBus,
+                     std::uint8_t aDeviceAddress = KDefaultAddress ) NOEXCEPT
+        : iTransport{ aI2CBus, aDeviceAddress }
+    {
+    }
+
+    /**
+     * @brief Construct the HAL on the transport, e.g. a CSsd1306SpiTransport.
+     */
+    explicit CSsd1306HalBase( const taTransport& aTransport ) NOEXCEPT
+        : iTransport{ aTransport }
     {
     }
 
     ~CSsd1306HalBase( ) = default;
 
+    inline std::uint8_t
+    DeviceAddress( ) const NOEXCEPT
+    {
+        return iTransport.DeviceAddress( );
+    }
+
+    /**
+     * @brief Sets the transfer limits of the bus. The RAM data and the command streams are
+     * split into the transactions within the maximum transfer size.
+     */
+    inline void
+    SetTransferLimits( const TTransferLimits& aLimits ) NOEXCEPT
+    {
+        // The SH1106 page row header and at least one data byte must fit a transaction
+        assert( aLimits.iMaxTransferSize == 0 || aLimits.iMaxTransferSize > KPageRowHeaderSize );
+        iTransferPlanner = CTransferPlanner{ aLimits };
+    }
+
+    inline const CTransferPlanner&
+    TransferPlanner( ) const NOEXCEPT
+    {
+        return iTransferPlanner;
+    }
+
     // Fundamental Command
     inline TErrorCode
     EnableFillWholeRamWith( bool aBitValue ) NOEXCEPT
@@ -131,7 +368,7 @@ public:
             = { static_cast< std::uint8_t >( KCommand | aScrollDirectionLeft ),
                 KDummyByte,
                 static_cast< std::uint8_t >( aStartPage & 0x07 ),
-                static_cast< std::uint8_t >( aScrollStepInterval & 0x07 ),
+                static_cast< std::uint8_t >( aScrollStepInterval ),
                 static_cast< std::uint8_t >( aEndPage & 0x07 ),
                 KDummyByte,
                 KDummyEndByte };
@@ -160,7 +397,7 @@ public:
             = { aScrollDirectionLeft ? KScrollDirectionLeft : KScrollDirectionRight,
                 KDummyByte,
                 static_cast< std::uint8_t >( aStartPage & 0x07 ),
-                static_cast< std::uint8_t >( aScrollStepInterval & 0x07 ),
+                static_cast< std::uint8_t >( aScrollStepInterval ),
                 static_cast< std::uint8_t >( aEndPage & 0x07 ),
                 static_cast< std::uint8_t >( aVerticalScrollOffset & 0x3F ) };
         return SendCommands( commands );
@@ -203,6 +440,7 @@ public:
     TErrorCode inline SetLowerColumnStartAddress( std::uint8_t aStartAddress ) NOEXCEPT
     {
         assert( aStartAddress <= 0x0F );
+        iRamPointerSynchronized = false;
         return SendCommand( static_cast< std::uint8_t >( aStartAddress & 0x0F ) );
     }
 
@@ -210,6 +448,7 @@ public:
     {
         constexpr std::uint8_t KCmdCSetLowerColumnStartAddress = 0x10;
         assert( aStartAddress <= 0x0F );
+        iRamPointerSynchronized = false;
         return SendCommand(
             static_cast< std::uint8_t >( KCmdCSetLowerColumnStartAddress | aStartAddress & 0x0F ) );
     }
@@ -235,6 +474,10 @@ public:
         return SendCommands( commands );
     }
 
+    /**
+     * @brief Sets the column window of the RAM data. The addresses are the panel columns, the
+     * panel column offset is added by the driver.
+     */
     TErrorCode
     SetColumnAddress( std::uint8_t aColumnStartAddress, std::uint8_t aColumnLastAddress ) NOEXCEPT
     {
@@ -244,23 +487,48 @@ public:
         assert( aColumnStartAddress < KMaxColumns );
         assert( aColumnLastAddress < KMaxColumns );
 
+        const std::uint8_t columnOffset = ColumnOffset( );
+        if ( KPageAddressingOnly )
+        {
+            iRamWindow.iBeginColumn
+                = static_cast< std::uint8_t >( columnOffset + aColumnStartAddress );
+            iRamWindow.iLastColumn
+                = static_cast< std::uint8_t >( columnOffset + aColumnLastAddress );
+            iRamColumn = iRamWindow.iBeginColumn;
+            iRamPointerSynchronized = false;
+            return KOk;
+        }
+
         const std::uint8_t commands[] = {
             KCmdSetColumnAddress,
-            static_cast< std::uint8_t >( aColumnStartAddress & 0x7F ),
-            static_cast< std::uint8_t >( aColumnLastAddress & 0x7F ),
+            static_cast< std::uint8_t >( ( columnOffset + aColumnStartAddress ) & 0x7F ),
+            static_cast< std::uint8_t >( ( columnOffset + aColumnLastAddress ) & 0x7F ),
         };
 
         return SendCommands( commands );
     }
 
+    /**
+     * @brief Sets the page window of the RAM data. The pages past the panel ones can be addressed
+     * as well, e.g. to prepare the content shown by the display start line change.
+     */
     TErrorCode
     SetPageAddress( std::uint8_t aPageStartAddress, std::uint8_t aPageLastAddress ) NOEXCEPT
     {
         using namespace AbstractPlatform;
         constexpr std::uint8_t KCmdSetColumnAddress = 0x22;
 
-        assert( aPageStartAddress < KMaxPages );
-        assert( aPageLastAddress < KMaxPages );
+        assert( aPageStartAddress < KRamPages );
+        assert( aPageLastAddress < KRamPages );
+
+        if ( KPageAddressingOnly )
+        {
+            iRamWindow.iBeginPage = aPageStartAddress;
+            iRamWindow.iLastPage = aPageLastAddress;
+            iRamPage = iRamWindow.iBeginPage;
+            iRamPointerSynchronized = false;
+            return KOk;
+        }
 
         const std::uint8_t commands[] = {
             KCmdSetColumnAddress,
@@ -275,6 +543,7 @@ public:
     {
         constexpr std::uint8_t KCmdPageStartAddress = 0xB0;
         assert( aPageStartAddress <= 0x07 );
+        iRamPointerSynchronized = false;
         return SendCommand(
             static_cast< std::uint8_t >( KCmdPageStartAddress | aPageStartAddress & 0x07 ) );
     }
@@ -325,6 +594,38 @@ public:
         return SendCommand( static_cast< std::uint8_t >( aOutputScanDirection ) );
     }
 
+    /**
+     * @brief Mirrors the panel image by the segment remap and the COM scan direction relative
+     * to the panel wiring. Both mirrorings together rotate the image by 180 degrees. The
+     * setting is kept by the HAL and applied again by Init().
+     *
+     * The segment remap affects only the data written after it, send the whole image again.
+     *
+     * @param aHorizontal Mirror the panel columns
+     * @param aVertical Mirror the panel rows
+     */
+    TErrorCode
+    SetMirroring( bool aHorizontal, bool aVertical ) NOEXCEPT
+    {
+        iMirrorHorizontal = aHorizontal;
+        iMirrorVertical = aVertical;
+        CCommandStream stream{ *this };
+        RETURN_ON_ERROR( SendMirroring( ) );
+        return stream.Flush( );
+    }
+
+    inline bool
+    MirroredHorizontally( ) const NOEXCEPT
+    {
+        return iMirrorHorizontal;
+    }
+
+    inline bool
+    MirroredVertically( ) const NOEXCEPT
+    {
+        return iMirrorVertical;
+    }
+
     /**
      * @brief Set vertical shift by COM from 0d~63d.
      * The value is reset to 00h after RESET.
@@ -429,6 +730,19 @@ public:
         return SendCommand( KCmdNop );
     }
 
+    /**
+     * @brief Completes the command left incomplete by an interrupted transaction with NOPs, so
+     * the commands sent next are not taken for its parameters.
+     */
+    TErrorCode
+    SynchronizeCommands( ) NOEXCEPT
+    {
+        constexpr std::uint8_t KCmdNop = 0xE3;
+        // The longest command, the continuous scroll setup, takes 6 parameters
+        const std::uint8_t commands[] = { KCmdNop, KCmdNop, KCmdNop, KCmdNop, KCmdNop, KCmdNop };
+        return SendCommands( commands );
+    }
+
     // Charge Pump Command
     TErrorCode
     EnablePumpSettings( bool aEnable = false ) NOEXCEPT
@@ -448,31 +762,31 @@ public:
     AbstractPlatform::TErrorCode
     SendCommand( uint8_t aCommand, bool aNoStop = false ) NOEXCEPT
     {
-        // I2C write process expects a control byte followed by data
-        // this "data" can be a command or data to follow up a command
-        // Co = 1, D/C = 0 => the driver expects a command
-        constexpr std::uint8_t controlByte = 0x80;
+        SSD1306_INSTRUMENT_SCOPE( iInstrumentation, SendCommand );
 
-        if ( iI2CBus.WriteRegisterRaw( iDeviceAddress, controlByte, aCommand ) )
+        if ( iCommandStream != nullptr )
         {
-            return AbstractPlatform::KGenericError;
+            return iCommandStream->Append( &aCommand, 1 );
         }
-        return AbstractPlatform::KOk;
+
+        SSD1306_INSTRUMENT_TRANSACTION( iInstrumentation, 1, 0 );
+        return iTransport.WriteCommand( aCommand );
     }
 
     AbstractPlatform::TErrorCode
     SendCommands( const uint8_t* aCommands, size_t aCommandsNumber ) NOEXCEPT
     {
-        AbstractPlatform::TErrorCode result = AbstractPlatform::KOk;
-        for ( size_t i = 0; i < aCommandsNumber; i++ )
+        SSD1306_INSTRUMENT_SCOPE( iInstrumentation, SendCommands );
+
+        if ( iCommandStream != nullptr )
         {
-            result = SendCommand( aCommands[ i ], ( i + 1 ) < aCommandsNumber );
-            if ( result != AbstractPlatform::KOk )
-            {
-                break;
-            }
+            return iCommandStream->Append( aCommands, aCommandsNumber );
         }
-        return result;
+
+        // Send the whole sequence as a single command stream transaction
+        CCommandStream stream{ *this };
+        RETURN_ON_ERROR( stream.Append( aCommands, aCommandsNumber ) );
+        return stream.Flush( );
     }
 
     template < size_t taArrayElemets >
@@ -483,130 +797,474 @@ public:
         return SendCommands( aCommands, taArrayElemets );
     }
 
+    /**
+     * @brief Sends the RAM data prefixed by the data control byte. The data is split into the
+     * transactions within the transfer limits: the first one goes right from the buffer, the
+     * others are gathered from the control byte and the data by the scatter-gather bus or,
+     * lacking one, copied into a stack chunk. The D/C line transports skip the control byte.
+     *
+     * @param aDataBuffer The data control byte followed by the data
+     */
     inline AbstractPlatform::TErrorCode
     SendRawBuffer( const uint8_t* aDataBuffer, size_t aBufferSize, bool aNoStop = false ) NOEXCEPT
     {
         assert( aDataBuffer != nullptr );
+        assert( aBufferSize >= sizeof( KCmdSetRamBuffer ) );
+        SSD1306_INSTRUMENT_SCOPE( iInstrumentation, SendRawBuffer );
+
+        // Pending commands must reach the device before the data they are related to
+        if ( iCommandStream != nullptr )
+        {
+            RETURN_ON_ERROR( iCommandStream->Flush( ) );
+        }
+        return WriteRamData( aDataBuffer + sizeof( KCmdSetRamBuffer ), nullptr,
+                             aBufferSize - sizeof( KCmdSetRamBuffer ), aNoStop, true );
+    }
+
+    /**
+     * @brief Sends the RAM data, the data control byte is prefixed to every transaction. The
+     * scatter-gather bus sends the data without copying it, the other buses get it copied into
+     * the stack chunks.
+     */
+    inline AbstractPlatform::TErrorCode
+    SendRamData( const uint8_t* aData, size_t aSize, bool aNoStop = false ) NOEXCEPT
+    {
+        assert( aData != nullptr || aSize == 0 );
+        SSD1306_INSTRUMENT_SCOPE( iInstrumentation, SendRawBuffer );
+
+        if ( iCommandStream != nullptr )
+        {
+            RETURN_ON_ERROR( iCommandStream->Flush( ) );
+        }
+        return WriteRamData( aData, nullptr, aSize, aNoStop, false );
+    }
+
+    /**
+     * @brief Sends the RAM data preceded by a headroom byte owned by the caller. Unless the bus
+     * gathers the transactions, the headroom byte is replaced by the data control byte while
+     * the first transaction is written and restored after, so the data fitting one transaction
+     * goes without copying. The next transactions are gathered or copied into the stack chunks
+     * as by SendRamData(), the data itself is never written. The D/C line transports neither
+     * need nor touch the headroom byte.
+     */
+    inline AbstractPlatform::TErrorCode
+    SendRamDataInPlace( uint8_t* aData, size_t aSize, bool aNoStop = false ) NOEXCEPT
+    {
+        assert( aData != nullptr || aSize == 0 );
+        SSD1306_INSTRUMENT_SCOPE( iInstrumentation, SendRawBuffer );
 
-        return iI2CBus.Write( iDeviceAddress, aDataBuffer, aBufferSize, aNoStop ) == aBufferSize
-                   ? AbstractPlatform::KOk
-                   : AbstractPlatform::KGenericError;
+        if ( iCommandStream != nullptr )
+        {
+            RETURN_ON_ERROR( iCommandStream->Flush( ) );
+        }
+        return WriteRamData( aData, aData, aSize, aNoStop, false );
+    }
+
+#if defined( SSD1306_INSTRUMENTATION )
+    /**
+     * @brief The bus statistics of the display, see SSD1306_Instrumentation.hpp.
+     */
+    inline CInstrumentation&
+    Instrumentation( ) NOEXCEPT
+    {
+        return iInstrumentation;
+    }
+#endif
+
+    /**
+     * @brief Configures the panel, clears the display RAM and switches the display on. The
+     * configuration and the RAM address windows go in one command stream transaction, the display
+     * on command in another one after the RAM data.
+     *
+     * @param aClearRam Clear the display RAM. Re-initializing the controller whose RAM content
+     * is going to be rewritten anyway can skip it, the configuration and the display on command
+     * then go in one transaction.
+     * @return TErrorCode KOk if succeed, otherwise appropriate error code
+     */
+    TErrorCode
+    Init( bool aClearRam = true ) NOEXCEPT
+    {
+        CCommandStream stream{ *this };
+        RETURN_ON_ERROR( SendCommands( KInitSequence, KInitSequenceSize ) );
+        if ( iMirrorHorizontal || iMirrorVertical )
+        {
+            RETURN_ON_ERROR( SendMirroring( ) );
+        }
+        if ( aClearRam )
+        {
+            RETURN_ON_ERROR( ClearRam( ) );
+        }
+        RETURN_ON_ERROR( DisplayEnable( true ) );
+        return stream.Flush( );
     }
 
     AbstractPlatform::TErrorCode
     ClearRam( ) NOEXCEPT
     {
         TErrorCode result = AbstractPlatform::KOk;
-        result = SetColumnAddress( 0, KMaxColumns - 1 );
-        if ( result != AbstractPlatform::KOk )
         {
-            return result;
+            CCommandStream stream{ *this };
+            SetColumnAddress( 0, KMaxColumns - 1 );
+            SetPageAddress( 0, KMaxPages - 1 );
+            result = stream.Flush( );
         }
-        result = SetPageAddress( 0, KMaxPages - 1 );
         if ( result != AbstractPlatform::KOk )
         {
             return result;
         }
 
-        /* clear screen RAM */
-        std::vector< std::uint8_t > dataBuffer( sizeof( KCmdSetRamBuffer ) + KRamSize, 0 );
-        dataBuffer[ 0 ] = KCmdSetRamBuffer;
-        return SendRawBuffer( dataBuffer.data( ), dataBuffer.size( ), false );
+        /* clear screen RAM by streaming the constant zero chunk */
+        const size_t maxChunkSize
+            = std::min( KClearRamChunkSize,
+                        iTransferPlanner.ChunkSize( KRamSize, KDataHeaderSize ) );
+        for ( size_t cleared = 0; cleared < KRamSize; cleared += maxChunkSize )
+        {
+            const auto chunkSize = std::min( maxChunkSize, KRamSize - cleared );
+            RETURN_ON_ERROR(
+                SendRawBuffer( KClearRamChunk, sizeof( KCmdSetRamBuffer ) + chunkSize, false ) );
+        }
+        return AbstractPlatform::KOk;
     }
 
 private:
-    /* data */
-    AbstractPlatform::CI2CBus iI2CBus;
-    const std::uint8_t iDeviceAddress;
-};
+    // The panel configuration sent by Init(), the display is kept off until the RAM is cleared
+    static constexpr std::uint8_t KInitSequence[] = {
+        0xAE,  // Display off
+        // Memory addressing mode, the page addressing only controllers don't have the command
+        KPageAddressingOnly ? 0xE3 : 0x20,
+        KPageAddressingOnly ? 0xE3 : HorizontalAddressingMode,
+        0x40,  // Display start line 0
+        taDisplayType::KSegmentRemap ? 0xA1 : 0xA0,
+        0xA8,  // Multiplex ratio
+        static_cast< std::uint8_t >( ( KPixelHight - 1 ) & 0x3F ),
+        static_cast< std::uint8_t >( taDisplayType::KCOMScanReversed
+                                         ? TOutputScanDirection::ReverseDirectionScan
+                                         : TOutputScanDirection::ForwardScanDirection ),
+        0xD3,  // Display offset
+        static_cast< std::uint8_t >( taDisplayType::KDisplayOffset & 0x3F ),
+        0xDA,  // COM pins hardware configuration
+        taDisplayType::KCOMPinsConfiguration,
+        0xD5,  // Display clock
+        taDisplayType::KDisplayClock,
+        0xD9,  // Pre-charge period
+        taDisplayType::KPreChargePeriod,
+        0xDB,  // VCOMH deselect level
+        taDisplayType::KVCOMHDeselectLevel,
+        0x81,  // Contrast
+        taDisplayType::KContrast,
+        0xA6,  // Normal display
+        // The SSD1306 charge pump or the SH1106 DC-DC converter
+        KController == TDisplayController::Sh1106 ? 0xAD : 0x8D,
+        KController == TDisplayController::Sh1106 ? ( taDisplayType::KChargePump ? 0x8B : 0x8A )
+                                                  : ( taDisplayType::KChargePump ? 0x14 : 0x10 ),
+        0xA4,  // Display the RAM content
+        0x2E,  // Deactivate scroll, the SSD1306 only: kept last, so the SH1106 sequence ends before it
+    };
+    static constexpr size_t KInitSequenceSize
+        = sizeof( KInitSequence ) - ( KController == TDisplayController::Sh1106 ? 1 : 0 );
+
+    // One page row of zeros prefixed by the RAM data control byte
+    static constexpr size_t KClearRamChunkSize = KMaxColumns;
+    static constexpr std::uint8_t KClearRamChunk[ sizeof( KCmdSetRamBuffer ) + KClearRamChunkSize ]
+        = { KCmdSetRamBuffer };
+
+    static constexpr std::uint8_t KMirroredColumnOffset
+        = static_cast< std::uint8_t >( KRamColumns - KColumnOffset - KMaxColumns );
+
+    // The page and column pointer commands preceding a page row on the SH1106, each one with
+    // its control byte, and the header of a page row transaction
+    static constexpr size_t KPointerCommandsSize = 6;
+    static constexpr size_t KPageRowHeaderSize
+        = taTransport::KControlBytes ? KPointerCommandsSize + sizeof( KCmdSetRamBuffer ) : 0;
+    // The data of a stack chunk copy: a page row, or a RAM data chunk of a bus driver limited to
+    // the 255 byte transfers, the 8-bit transfer counter of the most MCU I2C peripherals
+    static constexpr size_t KStagingChunkSize = 255 - sizeof( KCmdSetRamBuffer );
 
-template < typename taDisplayType >
-class CSsd1306Hal
-{
-};
+    /**
+     * @brief Writes the RAM data in the chunks chosen by the transfer planner.
+     *
+     * @param aWritableData The same data if the headroom byte preceding it may be borrowed for
+     * the control byte of the first chunk, nullptr otherwise
+     * @param aPrefixed The data is preceded by the control byte
+     */
+    AbstractPlatform::TErrorCode
+    WriteRamData( const uint8_t* aData,
+                  uint8_t* aWritableData,
+                  size_t aSize,
+                  bool aNoStop,
+                  bool aPrefixed ) NOEXCEPT
+    {
+        if ( KPageAddressingOnly )
+        {
+            return WritePageRows( aData, aSize, aNoStop );
+        }
 
-template <>
-class CSsd1306Hal< Ssd1306128x32 > : public CSsd1306HalBase< Ssd1306128x32 >
-{
-public:
-    using TErrorCode = AbstractPlatform::TErrorCode;
-    using TBase = CSsd1306HalBase< Ssd1306128x32 >;
-    using TBase::CSsd1306HalBase;
+        if constexpr ( taTransport::KControlBytes )
+        {
+            return WriteFramedData( aData, aWritableData, aSize, aNoStop, aPrefixed );
+        }
+        else
+        {
+            // Nothing to frame, every chunk is one bulk write right from the data
+            const size_t chunkSize = iTransferPlanner.ChunkSize( aSize, 0 );
+            for ( size_t offset = 0; offset < aSize; offset += chunkSize )
+            {
+                const size_t length = std::min( chunkSize, aSize - offset );
+                SSD1306_INSTRUMENT_TRANSACTION( iInstrumentation, 0, length );
+                RETURN_ON_ERROR( iTransport.WriteData( aData + offset, length ) );
+            }
+            return AbstractPlatform::KOk;
+        }
+    }
 
-    TErrorCode
-    Init( ) NOEXCEPT
+    /**
+     * @brief Writes the RAM data chunks, each one in its own transaction prefixed by the data
+     * control byte.
+     */
+    AbstractPlatform::TErrorCode
+    WriteFramedData( const uint8_t* aData,
+                     uint8_t* aWritableData,
+                     size_t aSize,
+                     bool aNoStop,
+                     bool aPrefixed ) NOEXCEPT
     {
-        using namespace AbstractPlatform;
-        RETURN_ON_ERROR( DisplayEnable( false ) );
-        RETURN_ON_ERROR(
-            SetMemoryAddressingMode( TMemoryAddressingMode::HorizontalAddressingMode ) );
-        RETURN_ON_ERROR( SetDisplayStartLine( 0 ) );
-        RETURN_ON_ERROR( SetSegmentRemap( true ) );  //+
-        RETURN_ON_ERROR( SetMultiplexRatio( KPixelHight - 1 ) );
-        RETURN_ON_ERROR( SetCOMOutputScanDirection( TOutputScanDirection::ReverseDirectionScan ) );
-        RETURN_ON_ERROR( SetDisplayOffset( 0 ) );
-
-        // set COM (common) pins hardware configuration. Board specific
-        // magic number. 0x02 Works for 128x32 (false, false), 0x12 Possibly works for
-        // 128x64. Other options 0x22, 0x32
-        RETURN_ON_ERROR( SetCOMPinsHardwareConfiguration( false, false ) );
-        RETURN_ON_ERROR( SetDisplayClock( 0x08, 0x01 ) );
-        RETURN_ON_ERROR( SetPreChargePeriod( 0x01, 0x0F ) );
-        RETURN_ON_ERROR( SetVCOMHDeselectLevel( TVCOMHDeselectLevel::Level_0_83Vcc ) );
-
-        /* display */
-        RETURN_ON_ERROR( SetContrast( 0xFF ) );
-        RETURN_ON_ERROR( InverseDisplay( false ) );
-        RETURN_ON_ERROR( EnablePumpSettings( true ) );
-        RETURN_ON_ERROR( DeactivateScroll( ) );
-        RETURN_ON_ERROR( ClearRam( ) );
-        RETURN_ON_ERROR( EnableFillWholeRamWith( false ) );
-        RETURN_ON_ERROR( DisplayEnable( true ) );
+        constexpr size_t KHeaderSize = sizeof( KCmdSetRamBuffer );
+
+        CTransferPlanner planner = iTransferPlanner;
+        const bool prefixedFirstChunk = aPrefixed || aWritableData != nullptr;
+        const bool staging
+            = !iTransport.Gathers( )
+              && ( !prefixedFirstChunk || planner.ChunksNumber( aSize, KHeaderSize ) > 1 );
+        if ( staging && planner.ChunkSize( aSize, KHeaderSize ) > KStagingChunkSize )
+        {
+            // The chunks not preceded by the control byte are copied into the stack chunk, the
+            // planned ones are kept as long as they fit it
+            planner = CTransferPlanner{ TTransferLimits{ KStagingChunkSize + KHeaderSize } };
+        }
 
+        const size_t chunkSize = planner.ChunkSize( aSize, KHeaderSize );
+        for ( size_t offset = 0; offset < aSize; offset += chunkSize )
+        {
+            const size_t length = std::min( chunkSize, aSize - offset );
+            const auto* chunk = aData + offset;
+            SSD1306_INSTRUMENT_TRANSACTION( iInstrumentation, 0, length );
+
+            TErrorCode result;
+            if ( offset == 0 && aPrefixed )
+            {
+                result = WriteTransaction( chunk - KHeaderSize, KHeaderSize + length, aNoStop );
+            }
+            else if ( offset == 0 && aWritableData != nullptr && !iTransport.Gathers( ) )
+            {
+                // Only the headroom byte is borrowed, the bytes preceding the next chunks are
+                // the data other code may be reading meanwhile
+                auto* prefix = aWritableData - KHeaderSize;
+                const auto borrowed = *prefix;
+                *prefix = KCmdSetRamBuffer;
+                result = WriteTransaction( prefix, KHeaderSize + length, aNoStop );
+                *prefix = borrowed;
+            }
+            else
+            {
+                result = WriteGathered( &KCmdSetRamBuffer, KHeaderSize, chunk, length, aNoStop );
+            }
+            RETURN_ON_ERROR( result );
+        }
         return AbstractPlatform::KOk;
     }
-};
 
-template <>
-class CSsd1306Hal< Ssd1306128x64 > : public CSsd1306HalBase< Ssd1306128x64 >
-{
-public:
-    using TErrorCode = AbstractPlatform::TErrorCode;
-    using TBase = CSsd1306HalBase< Ssd1306128x64 >;
-    using TBase::CSsd1306HalBase;
-
-    TErrorCode
-    Init( ) NOEXCEPT
+    /**
+     * @brief Writes the RAM data within the emulated address windows. Every transaction carries
+     * the data of one page row at most: the page and column pointer commands, each with its own
+     * single command control byte (Co = 1), followed by the data control byte and the data. The
+     * pointer commands are skipped when the data continues the row sent by the previous call.
+     * A page row exceeding the transfer limits is split, its next parts continue the row. The
+     * D/C line transports write the pointer commands and the row data separately.
+     */
+    AbstractPlatform::TErrorCode
+    WritePageRows( const uint8_t* aData, size_t aSize, bool aNoStop ) NOEXCEPT
     {
-        using namespace AbstractPlatform;
-        RETURN_ON_ERROR( DisplayEnable( false ) );
-        RETURN_ON_ERROR(
-            SetMemoryAddressingMode( TMemoryAddressingMode::HorizontalAddressingMode ) );
-        RETURN_ON_ERROR( SetDisplayStartLine( 0 ) );
-        RETURN_ON_ERROR( SetSegmentRemap( true ) );  //+
-        RETURN_ON_ERROR( SetMultiplexRatio( KPixelHight - 1 ) );
-        RETURN_ON_ERROR( SetCOMOutputScanDirection( TOutputScanDirection::ReverseDirectionScan ) );
-        RETURN_ON_ERROR( SetDisplayOffset( 0 ) );
-
-        // set COM (common) pins hardware configuration. Board specific
-        // magic number. 0x02 Works for 128x32 (false, false), 0x12 Possibly works for
-        // 128x64. Other options 0x22, 0x32
-        RETURN_ON_ERROR( SetCOMPinsHardwareConfiguration( true, false ) );
-        RETURN_ON_ERROR( SetDisplayClock( 0x08, 0x01 ) );
-        RETURN_ON_ERROR( SetPreChargePeriod( 0x01, 0x0F ) );
-        RETURN_ON_ERROR( SetVCOMHDeselectLevel( TVCOMHDeselectLevel::Level_0_83Vcc ) );
-
-        /* display */
-        RETURN_ON_ERROR( SetContrast( 0xFF ) );
-        RETURN_ON_ERROR( InverseDisplay( false ) );
-        RETURN_ON_ERROR( EnablePumpSettings( true ) );
-        RETURN_ON_ERROR( DeactivateScroll( ) );
-        RETURN_ON_ERROR( ClearRam( ) );
-        RETURN_ON_ERROR( EnableFillWholeRamWith( false ) );
-        RETURN_ON_ERROR( DisplayEnable( true ) );
+        constexpr std::uint8_t KSingleCommandControlByte = 0x80;
+        constexpr std::uint8_t KCmdPageStartAddress = 0xB0;
+        constexpr std::uint8_t KCmdLowerColumnStartAddress = 0x00;
+        constexpr std::uint8_t KCmdHigherColumnStartAddress = 0x10;
+
+        std::uint8_t header[ KPointerCommandsSize + sizeof( KCmdSetRamBuffer ) ];
+        header[ 0 ] = KSingleCommandControlByte;
+        header[ 2 ] = KSingleCommandControlByte;
+        header[ 4 ] = KSingleCommandControlByte;
+        header[ KPointerCommandsSize ] = KCmdSetRamBuffer;
+
+        while ( aSize != 0 )
+        {
+            const std::uint8_t* transactionHeader = header;
+            size_t headerSize = sizeof( header );
+            if ( iRamPointerSynchronized )
+            {
+                transactionHeader += KPointerCommandsSize;
+                headerSize -= KPointerCommandsSize;
+            }
+            else
+            {
+                header[ 1 ] = static_cast< std::uint8_t >( KCmdPageStartAddress | iRamPage );
+                header[ 3 ] = static_cast< std::uint8_t >( KCmdLowerColumnStartAddress
+                                                           | ( iRamColumn & 0x0F ) );
+                header[ 5 ] = static_cast< std::uint8_t >( KCmdHigherColumnStartAddress
+                                                           | ( iRamColumn >> 4 ) );
+            }
+            const size_t length = std::min< size_t >(
+                { aSize, iRamWindow.iLastColumn - iRamColumn + 1u,
+                  iTransferPlanner.MaxChunkSize( taTransport::KControlBytes ? headerSize : 0 ) } );
 
+            if ( WritePageRow( transactionHeader, headerSize, aData, length, aNoStop )
+                 != AbstractPlatform::KOk )
+            {
+                iRamPointerSynchronized = false;
+                return AbstractPlatform::KGenericError;
+            }
+
+            aData += length;
+            aSize -= length;
+            iRamColumn = static_cast< std::uint8_t >( iRamColumn + length );
+            // The controller column pointer doesn't move to the next page at the row end
+            iRamPointerSynchronized = iRamColumn <= iRamWindow.iLastColumn;
+            if ( !iRamPointerSynchronized )
+            {
+                iRamColumn = iRamWindow.iBeginColumn;
+                iRamPage = iRamPage != iRamWindow.iLastPage
+                               ? static_cast< std::uint8_t >( iRamPage + 1 )
+                               : iRamWindow.iBeginPage;
+            }
+        }
         return AbstractPlatform::KOk;
     }
+
+    /**
+     * @brief Writes a part of a page row preceded by its transaction header, which holds the
+     * pointer commands unless the part continues the row.
+     */
+    AbstractPlatform::TErrorCode
+    WritePageRow( const uint8_t* aHeader,
+                  size_t aHeaderSize,
+                  const uint8_t* aData,
+                  size_t aSize,
+                  bool aNoStop ) NOEXCEPT
+    {
+        const bool pointerCommands = aHeaderSize > sizeof( KCmdSetRamBuffer );
+        if constexpr ( taTransport::KControlBytes )
+        {
+            SSD1306_INSTRUMENT_TRANSACTION( iInstrumentation, pointerCommands ? 3 : 0, aSize );
+            return WriteGathered( aHeader, aHeaderSize, aData, aSize, aNoStop );
+        }
+        else
+        {
+            if ( pointerCommands )
+            {
+                // The pointer commands without their control bytes
+                const std::uint8_t commands[] = { aHeader[ 1 ], aHeader[ 3 ], aHeader[ 5 ] };
+                SSD1306_INSTRUMENT_TRANSACTION( iInstrumentation, sizeof( commands ), 0 );
+                RETURN_ON_ERROR( iTransport.WriteCommands( commands, sizeof( commands ) ) );
+            }
+            SSD1306_INSTRUMENT_TRANSACTION( iInstrumentation, 0, aSize );
+            return iTransport.WriteData( aData, aSize );
+        }
+    }
+
+    inline AbstractPlatform::TErrorCode
+    WriteTransaction( const uint8_t* aTransaction, size_t aSize, bool aNoStop ) NOEXCEPT
+    {
+        return iTransport.Write( aTransaction, aSize, aNoStop );
+    }
+
+    /**
+     * @brief Writes the header and the data of at most a page row or a staged RAM data chunk as
+     * one transaction, gathered by the bus if it can, otherwise copied into a stack chunk.
+     */
+    AbstractPlatform::TErrorCode
+    WriteGathered( const uint8_t* aHeader,
+                   size_t aHeaderSize,
+                   const uint8_t* aData,
+                   size_t aSize,
+                   bool aNoStop ) NOEXCEPT
+    {
+        if ( iTransport.Gathers( ) )
+        {
+            return iTransport.WriteGathered( aHeader, aHeaderSize, aData, aSize, aNoStop );
+        }
+
+        assert( aHeaderSize <= KPageRowHeaderSize );
+        assert( aSize <= KStagingChunkSize );
+        std::uint8_t chunk[ KPageRowHeaderSize + KStagingChunkSize ];
+        std::memcpy( chunk, aHeader, aHeaderSize );
+        std::memcpy( chunk + aHeaderSize, aData, aSize );
+        return WriteTransaction( chunk, aHeaderSize + aSize, aNoStop );
+    }
+
+    /**
+     * @brief The RAM column shown as the first panel column. The mirrored segment remap moves
+     * the visible RAM window to the other end of the RAM.
+     */
+    inline std::uint8_t
+    ColumnOffset( ) const NOEXCEPT
+    {
+        return iMirrorHorizontal ? KMirroredColumnOffset : KColumnOffset;
+    }
+
+    inline TErrorCode
+    SendMirroring( ) NOEXCEPT
+    {
+        RETURN_ON_ERROR( SetSegmentRemap( taDisplayType::KSegmentRemap != iMirrorHorizontal ) );
+        return SetCOMOutputScanDirection( taDisplayType::KCOMScanReversed != iMirrorVertical
+                                              ? TOutputScanDirection::ReverseDirectionScan
+                                              : TOutputScanDirection::ForwardScanDirection );
+    }
+
+    inline AbstractPlatform::TErrorCode
+    WriteCommandStream( const uint8_t* aStream, size_t aStreamSize ) NOEXCEPT
+    {
+        SSD1306_INSTRUMENT_TRANSACTION( iInstrumentation, aStreamSize - KCommandHeaderSize, 0 );
+        if constexpr ( taTransport::KControlBytes )
+        {
+            return WriteTransaction( aStream, aStreamSize, false );
+        }
+        else
+        {
+            return iTransport.WriteCommands( aStream, aStreamSize );
+        }
+    }
+
+    /* data */
+    taTransport iTransport;
+    CTransferPlanner iTransferPlanner;
+    CCommandStream* iCommandStream = nullptr;
+
+    // The address windows and the RAM pointer emulated for the page addressing only controllers
+    struct TRamWindow
+    {
+        std::uint8_t iBeginColumn;
+        std::uint8_t iLastColumn;
+        std::uint8_t iBeginPage;
+        std::uint8_t iLastPage;
+    };
+    TRamWindow iRamWindow{ KColumnOffset, KColumnOffset + KMaxColumns - 1, 0, KMaxPages - 1 };
+    std::uint8_t iRamColumn = KColumnOffset;
+    std::uint8_t iRamPage = 0;
+    bool iRamPointerSynchronized = false;
+    // The image mirroring applied on top of the panel wiring, see SetMirroring()
+    bool iMirrorHorizontal = false;
+    bool iMirrorVertical = false;
+#if defined( SSD1306_INSTRUMENTATION )
+    CInstrumentation iInstrumentation;
+#endif
+};
+
+template < typename taDisplayType,
+           typename taTransport = typename taDisplayType::TTransport >
+class CSsd1306Hal : public CSsd1306HalBase< taDisplayType, taTransport >
+{
+public:
+    using TBase = CSsd1306HalBase< taDisplayType, taTransport >;
+    using TBase::CSsd1306HalBase;
 };
 
 }  // namespace Ssd1306
@@ -0,0 +1,117 @@
+#pragma once
+#include <AbstractPlatform/common/Platform.hpp>
+#include <AbstractPlatform/common/ErrorCode.hpp>
+#include <AbstractPlatform/i2c/AbstractI2C.hpp>
+#include <ExternalHardware/ssd1306/SSD1306_Transfer.hpp>
+
+#include <cassert>
+#include <cstdint>
+
+namespace ExternalHardware
+{
+namespace Ssd1306
+{
+/**
+ * @brief The I2C transport of the HAL, the default one of the display types. The controller
+ * tells the commands from the RAM data by the control byte opening every transaction, so the
+ * HAL frames the command streams and the data chunks with the control bytes and the transport
+ * writes the framed transactions to the device address.
+ *
+ * A transport is a policy of CSsd1306HalBase: KControlBytes selects the framing and the members
+ * are the wire operations the framing needs. The I2C one writes whole transactions, gathered
+ * from the header and the data when the bus is an IScatterGatherI2CBus.
+ */
+class CSsd1306I2CTransport
+{
+public:
+    using TErrorCode = AbstractPlatform::TErrorCode;
+
+    // The transactions are framed by the control bytes
+    static constexpr bool KControlBytes = true;
+
+    CSsd1306I2CTransport( AbstractPlatform::IAbstractI2CBus& aI2CBus,
+                          std::uint8_t aDeviceAddress ) NOEXCEPT
+        : iI2CBus{ aI2CBus },
+          iDeviceAddress{ aDeviceAddress }
+    {
+    }
+
+    CSsd1306I2CTransport( IScatterGatherI2CBus& aI2CBus, std::uint8_t aDeviceAddress ) NOEXCEPT
+        : iI2CBus{ aI2CBus },
+          iDeviceAddress{ aDeviceAddress },
+          iScatterGatherBus{ &aI2CBus }
+    {
+    }
+
+    inline std::uint8_t
+    DeviceAddress( ) const NOEXCEPT
+    {
+        return iDeviceAddress;
+    }
+
+    /**
+     * @brief The bus can gather a transaction from several buffers, see WriteGathered().
+     */
+    inline bool
+    Gathers( ) const NOEXCEPT
+    {
+        return iScatterGatherBus != nullptr;
+    }
+
+    /**
+     * @brief Writes a single command transaction.
+     */
+    inline TErrorCode
+    WriteCommand( std::uint8_t aCommand ) NOEXCEPT
+    {
+        // I2C write process expects a control byte followed by data
+        // this "data" can be a command or data to follow up a command
+        // Co = 1, D/C = 0 => the driver expects a command
+        constexpr std::uint8_t controlByte = 0x80;
+
+        if ( iI2CBus.WriteRegisterRaw( iDeviceAddress, controlByte, aCommand ) )
+        {
+            return AbstractPlatform::KGenericError;
+        }
+        return AbstractPlatform::KOk;
+    }
+
+    /**
+     * @brief Writes a transaction framed by the HAL.
+     */
+    inline TErrorCode
+    Write( const std::uint8_t* aTransaction, size_t aSize, bool aNoStop ) NOEXCEPT
+    {
+        const int result = iI2CBus.Write( iDeviceAddress, aTransaction, aSize, aNoStop );
+        return result >= 0 && static_cast< size_t >( result ) == aSize
+                   ? AbstractPlatform::KOk
+                   : AbstractPlatform::KGenericError;
+    }
+
+    /**
+     * @brief Writes the header and the data as one transaction, requires Gathers().
+     */
+    inline TErrorCode
+    WriteGathered( const std::uint8_t* aHeader,
+                   size_t aHeaderSize,
+                   const std::uint8_t* aData,
+                   size_t aSize,
+                   bool aNoStop ) NOEXCEPT
+    {
+        assert( iScatterGatherBus != nullptr );
+
+        const TTransferSegment segments[] = { { aHeader, aHeaderSize }, { aData, aSize } };
+        const int result = iScatterGatherBus->WriteGathered( iDeviceAddress, segments, 2, aNoStop );
+        return result >= 0 && static_cast< size_t >( result ) == aHeaderSize + aSize
+                   ? AbstractPlatform::KOk
+                   : AbstractPlatform::KGenericError;
+    }
+
+private:
+    AbstractPlatform::CI2CBus iI2CBus;
+    const std::uint8_t iDeviceAddress;
+    // Set if the bus can gather a transaction from several buffers
+    IScatterGatherI2CBus* const iScatterGatherBus = nullptr;
+};
+}  // namespace Ssd1306
+}  // namespace ExternalHardware
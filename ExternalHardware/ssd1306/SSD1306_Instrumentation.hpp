@@ -0,0 +1,222 @@
+#pragma once
+#include <AbstractPlatform/common/Platform.hpp>
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Bus transaction instrumentation of the driver. Enabled by defining SSD1306_INSTRUMENTATION
+ * (the SSD1306_INSTRUMENTATION CMake option), otherwise the instrumentation macros expand to
+ * nothing and the driver carries no instrumentation state.
+ */
+
+namespace ExternalHardware
+{
+namespace Ssd1306
+{
+/**
+ * @brief The monotonic clock of the driver, returns the current time in microseconds. The time
+ * wraps around every 2^32 us (about 71 minutes), the intervals are measured as the unsigned
+ * differences, so they stay valid across the wrap.
+ */
+using TClock = std::uint32_t ( * )( );
+}  // namespace Ssd1306
+}  // namespace ExternalHardware
+
+#if defined( SSD1306_INSTRUMENTATION )
+
+namespace ExternalHardware
+{
+namespace Ssd1306
+{
+/**
+ * @brief The driver API the bus activity is attributed to. The nested calls are accounted to
+ * the outermost instrumented one, e.g. the address window commands sent by Render() are counted
+ * as Render() transactions.
+ */
+enum class TInstrumentedApi : std::uint8_t
+{
+    SendCommand = 0,
+    SendCommands,
+    SendRawBuffer,
+    Render,
+    Count
+};
+
+struct TApiStatistics
+{
+    // Log2 latency buckets: bucket 0 counts the latencies of 0 and 1 us, bucket N counts
+    // [2^N, 2^(N+1)) us, the last one counts everything above
+    static constexpr size_t KLatencyBuckets = 20;
+
+    std::uint32_t iCalls;
+    std::uint32_t iTransactions;
+    std::uint32_t iCommandBytes;
+    std::uint32_t iDataBytes;
+    std::uint32_t iMaxLatency;
+    std::uint32_t iLatencyHistogram[ KLatencyBuckets ];
+};
+
+struct TInstrumentationStatistics
+{
+    TApiStatistics iApis[ static_cast< size_t >( TInstrumentedApi::Count ) ];
+
+    inline const TApiStatistics&
+    operator[]( TInstrumentedApi aApi ) const NOEXCEPT
+    {
+        return iApis[ static_cast< size_t >( aApi ) ];
+    }
+
+    /**
+     * @brief The sum of the counters of all the APIs.
+     */
+    TApiStatistics
+    Total( ) const NOEXCEPT
+    {
+        TApiStatistics result{ };
+        for ( const auto& api : iApis )
+        {
+            result.iCalls += api.iCalls;
+            result.iTransactions += api.iTransactions;
+            result.iCommandBytes += api.iCommandBytes;
+            result.iDataBytes += api.iDataBytes;
+            result.iMaxLatency = api.iMaxLatency > result.iMaxLatency ? api.iMaxLatency
+                                                                      : result.iMaxLatency;
+            for ( size_t i = 0; i < TApiStatistics::KLatencyBuckets; ++i )
+            {
+                result.iLatencyHistogram[ i ] += api.iLatencyHistogram[ i ];
+            }
+        }
+        return result;
+    }
+};
+
+/**
+ * @brief Collects the bus statistics of one display.
+ */
+class CInstrumentation
+{
+public:
+    /**
+     * @brief Sets the clock used for the latency measurements of all the displays. The
+     * latencies are not measured until a clock is set.
+     */
+    static inline void
+    SetClock( TClock aClock ) NOEXCEPT
+    {
+        Clock( ) = aClock;
+    }
+
+    inline TInstrumentationStatistics
+    Snapshot( ) const NOEXCEPT
+    {
+        return iStatistics;
+    }
+
+    inline void
+    Reset( ) NOEXCEPT
+    {
+        iStatistics = TInstrumentationStatistics{ };
+    }
+
+    inline void
+    OnTransaction( size_t aCommandBytes, size_t aDataBytes ) NOEXCEPT
+    {
+        auto& api = iStatistics.iApis[ static_cast< size_t >( iCurrentApi ) ];
+        ++api.iTransactions;
+        api.iCommandBytes += static_cast< std::uint32_t >( aCommandBytes );
+        api.iDataBytes += static_cast< std::uint32_t >( aDataBytes );
+    }
+
+    /**
+     * @brief Accounts the call of an instrumented API for its lifetime.
+     */
+    class CScope
+    {
+    public:
+        CScope( CInstrumentation& aInstrumentation, TInstrumentedApi aApi ) NOEXCEPT
+            : iInstrumentation{ aInstrumentation }
+            , iOutermost{ aInstrumentation.iDepth++ == 0 }
+            , iStart{ 0 }
+        {
+            if ( iOutermost )
+            {
+                iInstrumentation.iCurrentApi = aApi;
+                const auto clock = Clock( );
+                iStart = clock != nullptr ? clock( ) : 0;
+            }
+        }
+
+        CScope( const CScope& ) = delete;
+        CScope& operator=( const CScope& ) = delete;
+
+        ~CScope( )
+        {
+            --iInstrumentation.iDepth;
+            if ( iOutermost )
+            {
+                const auto clock = Clock( );
+                iInstrumentation.OnCallCompleted( clock != nullptr ? clock( ) - iStart : 0 );
+            }
+        }
+
+    private:
+        CInstrumentation& iInstrumentation;
+        const bool iOutermost;
+        std::uint32_t iStart;
+    };
+
+private:
+    static inline TClock&
+    Clock( ) NOEXCEPT
+    {
+        static TClock clock = nullptr;
+        return clock;
+    }
+
+    void
+    OnCallCompleted( std::uint32_t aLatency ) NOEXCEPT
+    {
+        auto& api = iStatistics.iApis[ static_cast< size_t >( iCurrentApi ) ];
+        ++api.iCalls;
+        api.iMaxLatency = aLatency > api.iMaxLatency ? aLatency : api.iMaxLatency;
+
+        size_t bucket = 0;
+        for ( auto latency = aLatency >> 1; latency != 0; latency >>= 1 )
+        {
+            ++bucket;
+        }
+        if ( bucket >= TApiStatistics::KLatencyBuckets )
+        {
+            bucket = TApiStatistics::KLatencyBuckets - 1;
+        }
+        ++api.iLatencyHistogram[ bucket ];
+    }
+
+    TInstrumentationStatistics iStatistics{ };
+    TInstrumentedApi iCurrentApi = TInstrumentedApi::SendCommand;
+    std::uint8_t iDepth = 0;
+};
+}  // namespace Ssd1306
+}  // namespace ExternalHardware
+
+#define SSD1306_INSTRUMENT_SCOPE( aInstrumentation, aApi )                          \
+    ::ExternalHardware::Ssd1306::CInstrumentation::CScope instrumentationScope      \
+    {                                                                               \
+        aInstrumentation, ::ExternalHardware::Ssd1306::TInstrumentedApi::aApi       \
+    }
+#define SSD1306_INSTRUMENT_TRANSACTION( aInstrumentation, aCommandBytes, aDataBytes ) \
+    ( aInstrumentation ).OnTransaction( aCommandBytes, aDataBytes )
+
+#else
+
+#define SSD1306_INSTRUMENT_SCOPE( aInstrumentation, aApi ) \
+    do                                                     \
+    {                                                      \
+    } while ( false )
+#define SSD1306_INSTRUMENT_TRANSACTION( aInstrumentation, aCommandBytes, aDataBytes ) \
+    do                                                                                \
+    {                                                                                 \
+    } while ( false )
+
+#endif
@@ -0,0 +1,424 @@
+#pragma once
+#include <AbstractPlatform/common/Platform.hpp>
+#include <AbstractPlatform/common/ErrorCode.hpp>
+#include <AbstractPlatform/i2c/AbstractI2C.hpp>
+#include <ExternalHardware/ssd1306/SSD1306_Transfer.hpp>
+
+#include <fcntl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+namespace ExternalHardware
+{
+namespace Ssd1306
+{
+/**
+ * @brief The system calls of the i2c-dev bus, replaceable by a fake one for running the bus on
+ * the host without the device, e.g. forwarding the transfers to the emulator.
+ */
+class ILinuxI2CSyscalls
+{
+public:
+    virtual ~ILinuxI2CSyscalls( ) = default;
+
+    virtual int
+    Open( const char* aPath, int aFlags ) = 0;
+
+    virtual int
+    Close( int aFileDescriptor ) = 0;
+
+    virtual int
+    Ioctl( int aFileDescriptor, unsigned long aRequest, void* aArgument ) = 0;
+};
+
+/**
+ * @brief The system calls of the kernel.
+ */
+class CLinuxI2CSyscalls : public ILinuxI2CSyscalls
+{
+public:
+    static CLinuxI2CSyscalls&
+    Instance( ) NOEXCEPT
+    {
+        static CLinuxI2CSyscalls instance;
+        return instance;
+    }
+
+    int
+    Open( const char* aPath, int aFlags ) override
+    {
+        return ::open( aPath, aFlags );
+    }
+
+    int
+    Close( int aFileDescriptor ) override
+    {
+        return ::close( aFileDescriptor );
+    }
+
+    int
+    Ioctl( int aFileDescriptor, unsigned long aRequest, void* aArgument ) override
+    {
+        return ::ioctl( aFileDescriptor, aRequest, aArgument );
+    }
+};
+
+/**
+ * @brief The I2C bus of a Linux /dev/i2c-N adapter. Every transaction is an i2c_msg of the
+ * I2C_RDWR ioctl, which addresses the device per message, so no I2C_SLAVE call is needed.
+ *
+ * A syscall per transaction costs more than the transaction itself on the fast buses, so the
+ * writes made between BeginBatch() and EndBatch() are queued and sent as the messages of as few
+ * I2C_RDWR calls as possible: a whole render, the command stream, the address windows and the
+ * data chunks, goes in one syscall. The messages of a call are separated by repeated starts,
+ * which the display takes as separate transactions. The queued writes are copied, the callers
+ * may reuse their buffers at once. A batch is flushed early when the queue is full.
+ *
+ * The gathered writes outside a batch are sent without copying as one message followed by the
+ * I2C_M_NOSTART continuations when the adapter supports them.
+ *
+ * @note The bus errors of the queued writes are reported when the batch is flushed, the writes
+ * succeed when queued. The renders made in the batch have marked their areas clean by then, so
+ * mark them dirty again when EndBatch() fails. A batch error fails the rest of the batch writes.
+ */
+class CLinuxI2CBus : public IScatterGatherI2CBus
+{
+public:
+    using TErrorCode = AbstractPlatform::TErrorCode;
+
+    // The messages of an I2C_RDWR call and the bytes of a message accepted by i2c-dev
+    static constexpr size_t KMaxMessages = I2C_RDWR_IOCTL_MAX_MSGS;
+    static constexpr size_t KMaxMessageSize = 8192;
+    // The queued write bytes, a full frame of the largest display with its control bytes and
+    // command streams fits with room to spare
+    static constexpr size_t KBatchCapacity = 2048;
+
+    /**
+     * @brief Scope of a batch, flushed at the end of the scope unless committed before.
+     */
+    class CBatch
+    {
+    public:
+        explicit CBatch( CLinuxI2CBus& aBus ) NOEXCEPT
+            : iBus{ aBus }
+            , iCommitted{ false }
+        {
+            iBus.BeginBatch( );
+        }
+
+        CBatch( const CBatch& ) = delete;
+        CBatch& operator=( const CBatch& ) = delete;
+
+        ~CBatch( )
+        {
+            Commit( );
+        }
+
+        /**
+         * @brief Ends the batch.
+         *
+         * @return TErrorCode KOk if all the writes of the batch have been sent, otherwise the
+         * first error. Only the first call ends the batch.
+         */
+        TErrorCode
+        Commit( ) NOEXCEPT
+        {
+            if ( iCommitted )
+            {
+                return AbstractPlatform::KOk;
+            }
+            iCommitted = true;
+            return iBus.EndBatch( );
+        }
+
+    private:
+        CLinuxI2CBus& iBus;
+        bool iCommitted;
+    };
+
+    explicit CLinuxI2CBus( ILinuxI2CSyscalls& aSyscalls = CLinuxI2CSyscalls::Instance( ) ) NOEXCEPT
+        : iSyscalls{ aSyscalls }
+    {
+    }
+
+    CLinuxI2CBus( const CLinuxI2CBus& ) = delete;
+    CLinuxI2CBus& operator=( const CLinuxI2CBus& ) = delete;
+
+    ~CLinuxI2CBus( ) override
+    {
+        Close( );
+    }
+
+    /**
+     * @brief Opens the adapter device, e.g. /dev/i2c-1, and reads its functionality.
+     */
+    TErrorCode
+    Open( const char* aPath ) NOEXCEPT
+    {
+        assert( aPath != nullptr );
+
+        Close( );
+        iFileDescriptor = iSyscalls.Open( aPath, O_RDWR );
+        if ( iFileDescriptor < 0 )
+        {
+            return AbstractPlatform::KGenericError;
+        }
+
+        unsigned long functionality = 0;
+        if ( iSyscalls.Ioctl( iFileDescriptor, I2C_FUNCS, &functionality ) < 0
+             || ( functionality & I2C_FUNC_I2C ) == 0 )
+        {
+            Close( );
+            return AbstractPlatform::KGenericError;
+        }
+        iNoStartSupported = ( functionality & I2C_FUNC_NOSTART ) != 0;
+        return AbstractPlatform::KOk;
+    }
+
+    /**
+     * @brief Opens the adapter /dev/i2c-<aAdapter>.
+     */
+    TErrorCode
+    Open( unsigned aAdapter ) NOEXCEPT
+    {
+        char path[ sizeof( "/dev/i2c-4294967295" ) ];
+        std::snprintf( path, sizeof( path ), "/dev/i2c-%u", aAdapter );
+        return Open( path );
+    }
+
+    void
+    Close( ) NOEXCEPT
+    {
+        if ( iFileDescriptor >= 0 )
+        {
+            iSyscalls.Close( iFileDescriptor );
+            iFileDescriptor = -1;
+        }
+    }
+
+    inline bool
+    IsOpen( ) const NOEXCEPT
+    {
+        return iFileDescriptor >= 0;
+    }
+
+    inline bool
+    NoStartSupported( ) const NOEXCEPT
+    {
+        return iNoStartSupported;
+    }
+
+    /**
+     * @brief The transfer limits for CSsd1306Hal::SetTransferLimits(), the longest write the
+     * batch queue takes.
+     */
+    static constexpr TTransferLimits
+    Limits( ) NOEXCEPT
+    {
+        return TTransferLimits{ KBatchCapacity };
+    }
+
+    /**
+     * @brief Starts queuing the writes, the batches may be nested.
+     */
+    inline void
+    BeginBatch( ) NOEXCEPT
+    {
+        if ( iBatchDepth++ == 0 )
+        {
+            iBatchResult = AbstractPlatform::KOk;
+        }
+    }
+
+    /**
+     * @brief Sends the writes queued since the outermost BeginBatch().
+     *
+     * @return TErrorCode KOk if all the writes of the batch have been sent, otherwise the first
+     * error. The nested batches return the result so far.
+     */
+    TErrorCode
+    EndBatch( ) NOEXCEPT
+    {
+        assert( iBatchDepth != 0 );
+
+        if ( --iBatchDepth == 0 )
+        {
+            Flush( );
+        }
+        return iBatchResult;
+    }
+
+    int
+    Read( std::uint8_t aAddress, std::uint8_t* aDst, size_t aLength, bool aNoStop = false ) override
+    {
+        ( void )aNoStop;
+        assert( aDst != nullptr || aLength == 0 );
+
+        // The queued writes precede the read
+        ResetOutsideBatch( );
+        if ( Flush( ) != AbstractPlatform::KOk || aLength > KMaxMessageSize )
+        {
+            return -1;
+        }
+
+        i2c_msg message{ aAddress, I2C_M_RD, static_cast< __u16 >( aLength ), aDst };
+        return Transfer( &message, 1 ) ? static_cast< int >( aLength ) : -1;
+    }
+
+    int
+    Write( std::uint8_t aAddress,
+           const std::uint8_t* aSrc,
+           size_t aLength,
+           bool aNoStop = false ) override
+    {
+        assert( aSrc != nullptr || aLength == 0 );
+
+        const TTransferSegment segment{ aSrc, aLength };
+        return WriteGathered( aAddress, &segment, 1, aNoStop );
+    }
+
+    /**
+     * @brief Writes the segments as one transaction. The stop condition can't be held between
+     * the system calls, so aNoStop is ignored: the transactions end with a stop outside a batch
+     * and are joined by repeated starts in a batch.
+     */
+    int
+    WriteGathered( std::uint8_t aAddress,
+                   const TTransferSegment* aSegments,
+                   size_t aSegmentsNumber,
+                   bool aNoStop = false ) override
+    {
+        ( void )aNoStop;
+        assert( aSegments != nullptr || aSegmentsNumber == 0 );
+
+        size_t length = 0;
+        for ( size_t i = 0; i < aSegmentsNumber; ++i )
+        {
+            length += aSegments[ i ].iSize;
+        }
+        if ( length > KMaxMessageSize )
+        {
+            return -1;
+        }
+
+        if ( iBatchDepth == 0 && iNoStartSupported && aSegmentsNumber <= KMaxMessages )
+        {
+            i2c_msg messages[ KMaxMessages ];
+            for ( size_t i = 0; i < aSegmentsNumber; ++i )
+            {
+                messages[ i ] = i2c_msg{ aAddress,
+                                         static_cast< __u16 >( i == 0 ? 0 : I2C_M_NOSTART ),
+                                         static_cast< __u16 >( aSegments[ i ].iSize ),
+                                         const_cast< __u8* >( aSegments[ i ].iData ) };
+            }
+            return Transfer( messages, aSegmentsNumber ) ? static_cast< int >( length ) : -1;
+        }
+
+        // Queued as one message, sent at once outside a batch
+        ResetOutsideBatch( );
+        if ( iBatchResult != AbstractPlatform::KOk || !Queue( aAddress, aSegments, aSegmentsNumber,
+                                                              length ) )
+        {
+            return -1;
+        }
+        if ( iBatchDepth == 0 && Flush( ) != AbstractPlatform::KOk )
+        {
+            return -1;
+        }
+        return static_cast< int >( length );
+    }
+
+private:
+    /**
+     * @brief Forgets the error of the previous write, which only the batches carry on.
+     */
+    inline void
+    ResetOutsideBatch( ) NOEXCEPT
+    {
+        if ( iBatchDepth == 0 )
+        {
+            iBatchResult = AbstractPlatform::KOk;
+        }
+    }
+
+    /**
+     * @brief Copies the write to the queue, flushing the queue first if it has no room.
+     */
+    bool
+    Queue( std::uint8_t aAddress,
+           const TTransferSegment* aSegments,
+           size_t aSegmentsNumber,
+           size_t aLength ) NOEXCEPT
+    {
+        if ( aLength > KBatchCapacity )
+        {
+            return false;
+        }
+        if ( iMessagesNumber == KMaxMessages || iBatchSize + aLength > KBatchCapacity )
+        {
+            if ( Flush( ) != AbstractPlatform::KOk )
+            {
+                return false;
+            }
+        }
+
+        auto* data = iBatchBuffer + iBatchSize;
+        for ( size_t i = 0; i < aSegmentsNumber; ++i )
+        {
+            std::memcpy( iBatchBuffer + iBatchSize, aSegments[ i ].iData, aSegments[ i ].iSize );
+            iBatchSize += aSegments[ i ].iSize;
+        }
+        iMessages[ iMessagesNumber++ ]
+            = i2c_msg{ aAddress, 0, static_cast< __u16 >( aLength ), data };
+        return true;
+    }
+
+    /**
+     * @brief Sends the queued messages in one system call. The queue is emptied also on
+     * failure, the first error is kept for the end of the batch.
+     */
+    TErrorCode
+    Flush( ) NOEXCEPT
+    {
+        if ( iMessagesNumber != 0 )
+        {
+            const bool sent = Transfer( iMessages, iMessagesNumber );
+            iMessagesNumber = 0;
+            iBatchSize = 0;
+            if ( !sent && iBatchResult == AbstractPlatform::KOk )
+            {
+                iBatchResult = AbstractPlatform::KGenericError;
+            }
+        }
+        return iBatchResult;
+    }
+
+    bool
+    Transfer( i2c_msg* aMessages, size_t aMessagesNumber ) NOEXCEPT
+    {
+        i2c_rdwr_ioctl_data transfer{ aMessages, static_cast< __u32 >( aMessagesNumber ) };
+        return iFileDescriptor >= 0
+               && iSyscalls.Ioctl( iFileDescriptor, I2C_RDWR, &transfer )
+                      == static_cast< int >( aMessagesNumber );
+    }
+
+    ILinuxI2CSyscalls& iSyscalls;
+    int iFileDescriptor = -1;
+    bool iNoStartSupported = false;
+
+    size_t iBatchDepth = 0;
+    TErrorCode iBatchResult = AbstractPlatform::KOk;
+    i2c_msg iMessages[ KMaxMessages ];
+    size_t iMessagesNumber = 0;
+    std::uint8_t iBatchBuffer[ KBatchCapacity ];
+    size_t iBatchSize = 0;
+};
+}  // namespace Ssd1306
+}  // namespace ExternalHardware
@@ -0,0 +1,501 @@
+#pragma once
+#include <AbstractPlatform/common/Platform.hpp>
+#include <AbstractPlatform/common/ErrorCode.hpp>
+#include <ExternalHardware/ssd1306/SSD1306.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+namespace ExternalHardware
+{
+namespace Ssd1306
+{
+/**
+ * @brief Scrolls a label through a band of the display in a loop: the content followed by a gap,
+ * the loop being at least as long as the band is wide. The motion is handed to the controller
+ * scroll engine when it can express it, so the marquee costs neither CPU nor bus time per frame.
+ * Otherwise the marquee falls back to the software scrolling, sending the shifted band every
+ * step from Update().
+ *
+ * The continuous horizontal scroll of the SSD1306 rotates whole page rows of its 128 column RAM
+ * a column every 2 to 254 frames. So the hardware takes the marquee when the band spans the
+ * pages over the full RAM width, the loop is exactly the RAM width (the wrap-around content is
+ * pre-staged in the GRAM) and one of the step intervals matches the speed within the tolerance.
+ * The SH1106 has no scroll engine, the narrower panels don't show the whole RAM row.
+ *
+ * The scroll phase is tracked from the time and the frame period of the panel, the time x step
+ * interval, as the controller doesn't report it. The controller doesn't allow the RAM access
+ * while scrolling, so the other renders have to be done between Suspend() and Resume(). Suspend
+ * stops the scroll and rewrites the band at the tracked phase, which realigns the image to the
+ * phase the later writes are placed for, e.g. the partial writes of ContentChanged().
+ *
+ * @note The hardware phase estimate is as accurate as the frame period, the oscillator of the
+ * controller differs between the parts, calibrate it with SetFramePeriod() if the suspended
+ * image jumps. The controller has one scroll engine, so only one marquee of a display can take
+ * it, start the others with the hardware scrolling disabled.
+ *
+ * @tparam taDisplayType The display type
+ */
+template < typename taDisplayType = Ssd1306128x32 >
+class CSsd1306Marquee
+{
+public:
+    using TSsd1306 = CSsd1306< taDisplayType >;
+    using TSsd1306Hal = typename TSsd1306::TSsd1306Hal;
+    using TPage = typename TSsd1306::TPage;
+    using TErrorCode = AbstractPlatform::TErrorCode;
+    using TScrollStepInterval = typename TSsd1306Hal::TScrollStepInterval;
+
+    static constexpr std::uint32_t KMicrosecondsPerSecond = 1000000;
+    // The typical oscillator frequency of the default display clock setting
+    static constexpr std::uint32_t KOscillatorFrequency = 370000;
+    // The frame period of the traits settings: the oscillator divided by the display clock
+    // divide ratio, the row period (the pre-charge phases and 50 clocks) and the multiplex ratio
+    static constexpr std::uint32_t KDefaultFramePeriod = static_cast< std::uint32_t >(
+        static_cast< std::uint64_t >( ( taDisplayType::KDisplayClock & 0x0F ) + 1u )
+        * ( ( taDisplayType::KPreChargePeriod & 0x0F ) + ( taDisplayType::KPreChargePeriod >> 4 )
+            + 50u )
+        * TSsd1306Hal::KPixelHight * KMicrosecondsPerSecond / KOscillatorFrequency );
+    // The controller can scroll the panel showing whole RAM rows
+    static constexpr bool KHardwareScroll
+        = taDisplayType::KController == TDisplayController::Ssd1306
+          && TSsd1306Hal::KColumnOffset == 0
+          && TSsd1306Hal::KMaxColumns == TSsd1306Hal::KRamColumns;
+
+    enum class TMode : std::uint8_t
+    {
+        Stopped,
+        Hardware,
+        Software
+    };
+
+    struct TMotion
+    {
+        // The content moves towards the first column
+        bool iLeft;
+        // The time the content moves by one column, in microseconds
+        std::uint32_t iStepPeriod;
+        // The blank columns following the content
+        std::uint8_t iGap = 16;
+        // The step period deviation accepted from the hardware scrolling, in percent
+        std::uint8_t iSpeedTolerance = 15;
+        bool iHardwareAllowed = true;
+    };
+
+    /**
+     * @brief Construct a new marquee over the band of the display
+     *
+     * @param aDisplay The display
+     * @param aClock The microsecond clock
+     */
+    CSsd1306Marquee( TSsd1306& aDisplay,
+                     TClock aClock,
+                     std::uint8_t aBeginColumn,
+                     std::uint8_t aLastColumn,
+                     std::uint8_t aBeginPage,
+                     std::uint8_t aLastPage ) NOEXCEPT
+        : iDisplay{ aDisplay }
+        , iClock{ aClock }
+        , iStorage{ }
+        , iWindow{ aBeginColumn, aLastColumn, aBeginPage, aLastPage,
+                   iStorage + KBufferAlignment, true }
+        , iFramePeriod{ KDefaultFramePeriod }
+    {
+        assert( aClock != nullptr );
+    }
+
+    // The window points into the inline storage, so the marquee can't be moved or copied
+    CSsd1306Marquee( const CSsd1306Marquee& ) = delete;
+    CSsd1306Marquee& operator=( const CSsd1306Marquee& ) = delete;
+
+    /**
+     * @brief Sets the measured frame period of the panel in microseconds, used by the hardware
+     * scrolling started next.
+     */
+    inline void
+    SetFramePeriod( std::uint32_t aFramePeriod ) NOEXCEPT
+    {
+        assert( aFramePeriod != 0 );
+        iFramePeriod = aFramePeriod;
+    }
+
+    inline std::uint32_t
+    FramePeriod( ) const NOEXCEPT
+    {
+        return iFramePeriod;
+    }
+
+    inline TMode
+    Mode( ) const NOEXCEPT
+    {
+        return iMode;
+    }
+
+    inline bool
+    Suspended( ) const NOEXCEPT
+    {
+        return iSuspended;
+    }
+
+    /**
+     * @brief The loop column shown at the first column of the band.
+     */
+    std::uint16_t
+    Phase( ) const NOEXCEPT
+    {
+        if ( iMode == TMode::Stopped || iSuspended )
+        {
+            return iPhase;
+        }
+        const std::uint32_t steps = ( iClock( ) - iPhaseTime ) / iStepPeriod;
+        return static_cast< std::uint16_t >( ( iPhase + steps % iPeriod ) % iPeriod );
+    }
+
+    /**
+     * @brief Whether the controller can scroll the content of the given width with the motion.
+     */
+    bool
+    HardwareScrollable( std::uint16_t aContentColumns, const TMotion& aMotion ) const NOEXCEPT
+    {
+        TScrollStepInterval interval;
+        return SelectInterval( aContentColumns, aMotion, interval ) != 0;
+    }
+
+    /**
+     * @brief Starts scrolling the content from its first column at the first band column.
+     *
+     * @param aContent The page-major content of aContentColumns columns by the band pages, must
+     * stay valid until the marquee is stopped
+     * @return TErrorCode KOk on success, otherwise the bus error. The marquee is left suspended
+     * on failure, Resume() retries.
+     */
+    TErrorCode
+    Start( const TPage* aContent, std::uint16_t aContentColumns, const TMotion& aMotion ) NOEXCEPT
+    {
+        assert( aContent != nullptr );
+        assert( aContentColumns != 0 );
+        assert( aMotion.iStepPeriod != 0 );
+        assert( aContentColumns + size_t{ aMotion.iGap } <= UINT16_MAX );
+
+        if ( iMode == TMode::Hardware && !iSuspended )
+        {
+            RETURN_ON_ERROR( iDisplay.Hal( ).DeactivateScroll( ) );
+        }
+
+        iContent = aContent;
+        iContentColumns = aContentColumns;
+        iLeft = aMotion.iLeft;
+        iPeriod = static_cast< std::uint16_t >(
+            std::max< size_t >( aContentColumns + size_t{ aMotion.iGap }, iWindow.Columns( ) ) );
+        iPhase = 0;
+        iStepPeriod = SelectInterval( aContentColumns, aMotion, iInterval );
+        iMode = iStepPeriod != 0 ? TMode::Hardware : TMode::Software;
+        if ( iMode == TMode::Software )
+        {
+            iStepPeriod = aMotion.iStepPeriod;
+        }
+        iSuspended = true;
+        iRewritePending = true;
+        return Resume( );
+    }
+
+    /**
+     * @brief Stops the scrolling, the band keeps showing the current phase.
+     */
+    TErrorCode
+    Stop( ) NOEXCEPT
+    {
+        RETURN_ON_ERROR( Suspend( ) );
+        if ( !iRewritePending )
+        {
+            iMode = TMode::Stopped;
+        }
+        return AbstractPlatform::KOk;
+    }
+
+    /**
+     * @brief Freezes the marquee at the current phase, the display RAM can be written until
+     * Resume(). The hardware scrolling is stopped and the band is rewritten at the phase.
+     */
+    TErrorCode
+    Suspend( ) NOEXCEPT
+    {
+        if ( iMode == TMode::Stopped || iSuspended )
+        {
+            return AbstractPlatform::KOk;
+        }
+
+        Advance( );
+        if ( iMode == TMode::Hardware )
+        {
+            RETURN_ON_ERROR( iDisplay.Hal( ).DeactivateScroll( ) );
+            iRewritePending = true;
+        }
+        else
+        {
+            // The software marquee shows the phase of its last step
+            iRewritePending = iRewritePending || iPhase != iShownPhase;
+        }
+        iSuspended = true;
+        return RewritePending( );
+    }
+
+    /**
+     * @brief Continues the marquee from the phase it has been suspended at.
+     */
+    TErrorCode
+    Resume( ) NOEXCEPT
+    {
+        if ( iMode == TMode::Stopped || !iSuspended )
+        {
+            return AbstractPlatform::KOk;
+        }
+
+        RETURN_ON_ERROR( RewritePending( ) );
+        if ( iMode == TMode::Hardware )
+        {
+            auto& hal = iDisplay.Hal( );
+            typename TSsd1306Hal::CCommandStream stream{ hal };
+            hal.ContinuousHorizontalScroll( iLeft, iWindow.BeginPage( ), iWindow.LastPage( ),
+                                            iInterval );
+            hal.ActivateScroll( );
+            RETURN_ON_ERROR( stream.Flush( ) );
+        }
+        iPhaseTime = iClock( );
+        iSuspended = false;
+        return AbstractPlatform::KOk;
+    }
+
+    /**
+     * @brief Sends the content columns changed by the application. The columns are written at
+     * the RAM columns showing them at the current phase, the hardware scrolling is suspended for
+     * the write and realigned.
+     */
+    TErrorCode
+    ContentChanged( std::uint16_t aBeginColumn, std::uint16_t aLastColumn ) NOEXCEPT
+    {
+        assert( aBeginColumn <= aLastColumn );
+        assert( aLastColumn < iContentColumns );
+
+        if ( iMode == TMode::Stopped )
+        {
+            return AbstractPlatform::KOk;
+        }
+        if ( iMode == TMode::Hardware && !iSuspended )
+        {
+            // The suspended band is rewritten with the new content as a whole
+            RETURN_ON_ERROR( Suspend( ) );
+            return Resume( );
+        }
+        if ( iRewritePending )
+        {
+            return RewritePending( );
+        }
+
+        Compose( iShownPhase );
+        // The content columns are contiguous in the loop, so they take at most two runs of the
+        // band: up to the loop end and the wrapped part from the loop start
+        const std::uint16_t begin = BandColumn( aBeginColumn, iShownPhase );
+        const std::uint32_t end = std::uint32_t{ begin } + aLastColumn - aBeginColumn + 1u;
+        RETURN_ON_ERROR( RenderColumns( begin, std::min< std::uint32_t >( end, iPeriod ) ) );
+        if ( end > iPeriod )
+        {
+            RETURN_ON_ERROR( RenderColumns( 0, end - iPeriod ) );
+        }
+        return AbstractPlatform::KOk;
+    }
+
+    /**
+     * @brief Moves the software marquee to the current phase, sending the band if it has
+     * changed. Call it at least every step period. The hardware marquee only keeps its phase
+     * reference fresh, a call every few minutes keeps the clock wrap away.
+     */
+    TErrorCode
+    Update( ) NOEXCEPT
+    {
+        if ( iMode == TMode::Stopped || iSuspended )
+        {
+            return AbstractPlatform::KOk;
+        }
+
+        Advance( );
+        if ( iMode == TMode::Hardware || iPhase == iShownPhase )
+        {
+            return AbstractPlatform::KOk;
+        }
+        Compose( iPhase );
+        RETURN_ON_ERROR( RenderColumns( 0, iWindow.Columns( ) ) );
+        iShownPhase = iPhase;
+        return AbstractPlatform::KOk;
+    }
+
+private:
+    static constexpr size_t KBufferAlignment = TSsd1306::KDefaultBufferAlignment;
+    static constexpr size_t KBufferSize
+        = static_cast< size_t >( TSsd1306Hal::KMaxColumns ) * TSsd1306Hal::KMaxPages;
+
+    struct TInterval
+    {
+        TScrollStepInterval iInterval;
+        std::uint8_t iFrames;
+    };
+
+    static constexpr TInterval KIntervals[] = {
+        { TScrollStepInterval::Step2Frame, 2 },     { TScrollStepInterval::Step3Frame, 3 },
+        { TScrollStepInterval::Step4Frame, 4 },     { TScrollStepInterval::Step5Frame, 5 },
+        { TScrollStepInterval::Step25Frame, 25 },   { TScrollStepInterval::Step64Frame, 64 },
+        { TScrollStepInterval::Step128Frames, 128 }, { TScrollStepInterval::Step254Frames, 254 },
+    };
+
+    /**
+     * @brief Selects the step interval closest to the motion speed.
+     *
+     * @return std::uint32_t The hardware step period, 0 if the hardware can't scroll the
+     * content with the motion
+     */
+    std::uint32_t
+    SelectInterval( std::uint16_t aContentColumns,
+                    const TMotion& aMotion,
+                    TScrollStepInterval& aInterval ) const NOEXCEPT
+    {
+        const bool fullRows = iWindow.BeginColumn( ) == 0
+                              && iWindow.Columns( ) == TSsd1306Hal::KRamColumns;
+        if ( !KHardwareScroll || !aMotion.iHardwareAllowed || !fullRows
+             || aContentColumns + size_t{ aMotion.iGap } > TSsd1306Hal::KRamColumns )
+        {
+            return 0;
+        }
+
+        std::uint32_t bestPeriod = 0;
+        std::uint32_t bestDeviation = UINT32_MAX;
+        for ( const auto& interval : KIntervals )
+        {
+            const std::uint32_t period = interval.iFrames * iFramePeriod;
+            const std::uint32_t deviation = period > aMotion.iStepPeriod
+                                                ? period - aMotion.iStepPeriod
+                                                : aMotion.iStepPeriod - period;
+            if ( deviation < bestDeviation )
+            {
+                bestDeviation = deviation;
+                bestPeriod = period;
+                aInterval = interval.iInterval;
+            }
+        }
+
+        const bool accepted = std::uint64_t{ bestDeviation } * 100u
+                              <= std::uint64_t{ aMotion.iStepPeriod } * aMotion.iSpeedTolerance;
+        return accepted ? bestPeriod : 0;
+    }
+
+    /**
+     * @brief Brings the phase to the current time, the reference time advances by the whole
+     * steps passed.
+     */
+    void
+    Advance( ) NOEXCEPT
+    {
+        const std::uint32_t steps = ( iClock( ) - iPhaseTime ) / iStepPeriod;
+        iPhaseTime += steps * iStepPeriod;
+        iPhase = static_cast< std::uint16_t >( ( iPhase + steps % iPeriod ) % iPeriod );
+    }
+
+    /**
+     * @brief The band column showing the loop column at the phase.
+     */
+    inline std::uint16_t
+    BandColumn( std::uint16_t aLoopColumn, std::uint16_t aPhase ) const NOEXCEPT
+    {
+        const std::uint32_t column = iLeft ? aLoopColumn + iPeriod - aPhase : aLoopColumn + aPhase;
+        return static_cast< std::uint16_t >( column % iPeriod );
+    }
+
+    /**
+     * @brief Fills the band buffer with the loop at the phase.
+     */
+    void
+    Compose( std::uint16_t aPhase ) NOEXCEPT
+    {
+        const size_t columns = iWindow.Columns( );
+        const size_t pages = iWindow.Rows( );
+        auto* band = iStorage + KBufferAlignment;
+        // The loop column shown at the first band column
+        std::uint16_t first = iLeft ? aPhase : static_cast< std::uint16_t >(
+                                                   ( iPeriod - aPhase ) % iPeriod );
+        for ( size_t page = 0; page < pages; ++page )
+        {
+            const auto* content = iContent + page * iContentColumns;
+            auto* row = band + page * columns;
+            std::uint16_t loopColumn = first;
+            for ( size_t column = 0; column < columns; ++column )
+            {
+                row[ column ] = loopColumn < iContentColumns ? content[ loopColumn ] : 0;
+                if ( ++loopColumn == iPeriod )
+                {
+                    loopColumn = 0;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Sends the band columns [aBeginColumn, aEndColumn) of the composed band, the part
+     * past the band is not shown.
+     */
+    TErrorCode
+    RenderColumns( std::uint32_t aBeginColumn, std::uint32_t aEndColumn ) NOEXCEPT
+    {
+        aEndColumn = std::min< std::uint32_t >( aEndColumn, iWindow.Columns( ) );
+        if ( aBeginColumn >= aEndColumn )
+        {
+            return AbstractPlatform::KOk;
+        }
+        return iDisplay.RenderRegion( iWindow, static_cast< std::uint8_t >( aBeginColumn ),
+                                      static_cast< std::uint8_t >( aEndColumn - 1 ), 0,
+                                      static_cast< std::uint8_t >( iWindow.Rows( ) - 1 ) );
+    }
+
+    /**
+     * @brief Rewrites the whole band at the phase if it is pending, the first write after the
+     * start and after the scroll is stopped.
+     */
+    TErrorCode
+    RewritePending( ) NOEXCEPT
+    {
+        if ( !iRewritePending )
+        {
+            return AbstractPlatform::KOk;
+        }
+        Compose( iPhase );
+        RETURN_ON_ERROR( RenderColumns( 0, iWindow.Columns( ) ) );
+        iShownPhase = iPhase;
+        iRewritePending = false;
+        return AbstractPlatform::KOk;
+    }
+
+    TSsd1306& iDisplay;
+    const TClock iClock;
+    // The headroom preceding the band buffer takes as much as the alignment
+    alignas( KBufferAlignment ) TPage iStorage[ KBufferAlignment + KBufferSize ];
+    typename TSsd1306::CExternalRenderArea iWindow;
+    std::uint32_t iFramePeriod;
+
+    const TPage* iContent = nullptr;
+    std::uint16_t iContentColumns = 0;
+    // The loop length, the content and the gap or the band width
+    std::uint16_t iPeriod = 1;
+    bool iLeft = true;
+    TMode iMode = TMode::Stopped;
+    bool iSuspended = false;
+    // The band has to be written as a whole before the next partial write
+    bool iRewritePending = false;
+    TScrollStepInterval iInterval = TScrollStepInterval::Step2Frame;
+    std::uint32_t iStepPeriod = 1;
+    // The phase at the reference time
+    std::uint16_t iPhase = 0;
+    std::uint32_t iPhaseTime = 0;
+    // The phase the band has been written at
+    std::uint16_t iShownPhase = 0;
+};
+}  // namespace Ssd1306
+}  // namespace ExternalHardware
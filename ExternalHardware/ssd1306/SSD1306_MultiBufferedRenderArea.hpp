@@ -0,0 +1,166 @@
+#pragma once
+#include <AbstractPlatform/common/Platform.hpp>
+#include <ExternalHardware/ssd1306/SSD1306.hpp>
+#include <ExternalHardware/ssd1306/SSD1306_DiffRenderer.hpp>
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+namespace ExternalHardware
+{
+namespace Ssd1306
+{
+/**
+ * @brief Triple-buffered render area for drawing and rendering from different tasks without
+ * tearing. The producer draws into the back buffer and publishes it, the transmitter picks the
+ * latest published buffer up as the front one. The buffers are exchanged through a single
+ * atomic index, so neither side ever blocks: the producer always has a free back buffer and the
+ * transmitter always sends a complete frame.
+ *
+ * With the diff renderer the transmitter sends only the bytes changed against the previously
+ * sent frame.
+ *
+ * @tparam taDisplayType The display type
+ * @tparam taBeginColumn The first display column covered by the area
+ * @tparam taLastColumn The last display column covered by the area
+ * @tparam taBeginPage The first display page covered by the area
+ * @tparam taLastPage The last display page covered by the area
+ */
+template < typename taDisplayType = Ssd1306128x32,
+           std::uint8_t taBeginColumn = 0,
+           std::uint8_t taLastColumn = CSsd1306Hal< taDisplayType >::KMaxColumns - 1,
+           std::uint8_t taBeginPage = 0,
+           std::uint8_t taLastPage = CSsd1306Hal< taDisplayType >::KMaxPages - 1 >
+class CSsd1306TripleBufferedRenderArea
+{
+public:
+    using TSsd1306 = CSsd1306< taDisplayType >;
+    using TRenderArea = typename TSsd1306::
+        template CStaticRenderArea< taBeginColumn, taLastColumn, taBeginPage, taLastPage >;
+    using TDiffRenderer = CSsd1306DiffRenderer< taDisplayType >;
+    using TErrorCode = AbstractPlatform::TErrorCode;
+
+    CSsd1306TripleBufferedRenderArea( ) NOEXCEPT
+        : iBack{ 0 }
+        , iMiddle{ 1 }
+        , iFront{ 2 }
+        , iFrontFailed{ false }
+    {
+    }
+
+    CSsd1306TripleBufferedRenderArea( const CSsd1306TripleBufferedRenderArea& ) = delete;
+    CSsd1306TripleBufferedRenderArea& operator=( const CSsd1306TripleBufferedRenderArea& )
+        = delete;
+
+    // Producer side
+
+    /**
+     * @brief The buffer to draw the next frame into. Owned by the producer until Publish().
+     */
+    inline TRenderArea&
+    Back( ) NOEXCEPT
+    {
+        return iBuffers[ iBack ];
+    }
+
+    /**
+     * @brief Hands the back buffer over to the transmitter and takes a free one.
+     *
+     * @param aKeepContent Copy the published frame into the new back buffer, so the producer
+     * can keep drawing incrementally. Otherwise the new back buffer content is undefined.
+     */
+    void
+    Publish( bool aKeepContent = true ) NOEXCEPT
+    {
+        const auto published = iBack;
+        const auto previous = iMiddle.exchange(
+            static_cast< std::uint8_t >( published | KFreshFlag ), std::memory_order_acq_rel );
+        iBack = static_cast< std::uint8_t >( previous & KIndexMask );
+
+        if ( aKeepContent )
+        {
+            // The published buffer can be read by the transmitter meanwhile. The renders write
+            // nothing but the headroom byte preceding its frame data, which CopyFrom() doesn't
+            // read, so both sides only read the frame data
+            iBuffers[ iBack ].CopyFrom( iBuffers[ published ] );
+        }
+    }
+
+    // Transmitter side
+
+    /**
+     * @brief Takes the latest published frame as the front buffer.
+     *
+     * @return const TRenderArea* The new front buffer or nullptr if nothing has been published
+     * since the previous call
+     */
+    const TRenderArea*
+    AcquireFront( ) NOEXCEPT
+    {
+        if ( ( iMiddle.load( std::memory_order_acquire ) & KFreshFlag ) == 0 )
+        {
+            return nullptr;
+        }
+
+        const auto previous = iMiddle.exchange( iFront, std::memory_order_acq_rel );
+        iFront = static_cast< std::uint8_t >( previous & KIndexMask );
+        return &iBuffers[ iFront ];
+    }
+
+    /**
+     * @brief Sends the changes of the latest published frame if there is one. A front frame
+     * whose render has failed is sent again by the next call unless a newer one is published.
+     *
+     * @param aRenderer The diff renderer of the display
+     * @param aSkippedBytes Receives the number of the bytes skipped as unchanged
+     * @param aRendered Receives whether a frame has been rendered
+     * @return TErrorCode KOk on success or if there is nothing to render, otherwise the bus
+     * error
+     */
+    TErrorCode
+    RenderLatest( TDiffRenderer& aRenderer,
+                  size_t* aSkippedBytes = nullptr,
+                  bool* aRendered = nullptr ) NOEXCEPT
+    {
+        if ( aRendered != nullptr )
+        {
+            *aRendered = false;
+        }
+
+        const auto* front = AcquireFront( );
+        if ( front == nullptr )
+        {
+            if ( !iFrontFailed )
+            {
+                return AbstractPlatform::KOk;
+            }
+            front = &iBuffers[ iFront ];
+        }
+
+        const auto result = aRenderer.Render( *front, aSkippedBytes );
+        iFrontFailed = result != AbstractPlatform::KOk;
+        if ( aRendered != nullptr )
+        {
+            *aRendered = !iFrontFailed;
+        }
+        return result;
+    }
+
+private:
+    static constexpr std::uint8_t KIndexMask = 0x03;
+    // Set in the middle index when it holds a frame the transmitter hasn't taken yet
+    static constexpr std::uint8_t KFreshFlag = 0x04;
+
+    TRenderArea iBuffers[ 3 ];
+    // Owned by the producer
+    std::uint8_t iBack;
+    // Shared, the index of the buffer in between plus the fresh flag
+    std::atomic< std::uint8_t > iMiddle;
+    // Owned by the transmitter
+    std::uint8_t iFront;
+    bool iFrontFailed;
+};
+}  // namespace Ssd1306
+}  // namespace ExternalHardware
@@ -0,0 +1,298 @@
+#pragma once
+#include <AbstractPlatform/common/Platform.hpp>
+#include <AbstractPlatform/common/ErrorCode.hpp>
+#include <ExternalHardware/ssd1306/SSD1306.hpp>
+
+#include <cassert>
+#include <cstdint>
+
+namespace ExternalHardware
+{
+namespace Ssd1306
+{
+/**
+ * @brief Renders through CSsd1306 and recovers from the bus faults. A failed render is retried
+ * with an exponential backoff; starting from the configured retry the controller is also
+ * re-initialized, as the glitch may have reset it or corrupted its addressing state. Every
+ * retry starts by completing the command the failed transaction may have cut with NOPs. The
+ * re-initialization doesn't clear the display RAM: the tracked render areas are marked unknown
+ * and sent again completely instead, so the panel shows the right content right away without
+ * a blank frame.
+ *
+ * A render area whose render has failed stays dirty, so a failed render doesn't lose changes
+ * even when the retries are exhausted. Only the areas registered by Track() are restored after
+ * a re-initialization; keep every area covering the visible content tracked.
+ *
+ * @tparam taDisplayType The display type
+ * @tparam taMaxAreas The maximum number of the tracked render areas
+ */
+template < typename taDisplayType = Ssd1306128x32, size_t taMaxAreas = 4 >
+class CSsd1306RecoveringRenderer
+{
+public:
+    using TSsd1306 = CSsd1306< taDisplayType >;
+    using TRenderArea = typename TSsd1306::CRenderAreaBase;
+    using TErrorCode = AbstractPlatform::TErrorCode;
+    // Blocks the caller for the given number of microseconds
+    using TDelay = void ( * )( std::uint32_t );
+
+    struct TRecoveryPolicy
+    {
+        // The render attempts after the failed one
+        std::uint8_t iMaxRetries = 3;
+        // The first retry re-initializing the controller, above iMaxRetries to never do that
+        std::uint8_t iReinitRetry = 2;
+        // The delay before the first retry in microseconds, doubled for every next one
+        std::uint32_t iInitialBackoff = 1000;
+        std::uint32_t iMaxBackoff = 64000;
+    };
+
+    struct TStatistics
+    {
+        // The failed bus operations: renders, re-initializations and area restores
+        std::uint32_t iFaults;
+        std::uint32_t iRetries;
+        std::uint32_t iReinits;
+        // The renders succeeded after a fault
+        std::uint32_t iRecoveries;
+        // The renders given up after all the retries
+        std::uint32_t iFailures;
+        // The tracked areas sent again after a re-initialization
+        std::uint32_t iRestoredAreas;
+        TErrorCode iLastError;
+    };
+
+    /**
+     * @brief Construct a new recovering renderer
+     *
+     * @param aDisplay The display
+     * @param aDelay The backoff delay function, the retries follow each other immediately if
+     * not set
+     * @param aPolicy The retry policy
+     */
+    explicit CSsd1306RecoveringRenderer( TSsd1306& aDisplay,
+                                         TDelay aDelay = nullptr,
+                                         TRecoveryPolicy aPolicy = TRecoveryPolicy{ } ) NOEXCEPT
+        : iDisplay{ aDisplay }
+        , iDelay{ aDelay }
+        , iPolicy{ aPolicy }
+        , iAreas{ }
+        , iAreasNumber{ 0 }
+        , iStatistics{ }
+        , iSynchronized{ true }
+    {
+    }
+
+    inline void
+    SetPolicy( TRecoveryPolicy aPolicy ) NOEXCEPT
+    {
+        iPolicy = aPolicy;
+    }
+
+    /**
+     * @brief Registers the render area to be restored after the controller re-initialization.
+     * The area must stay alive until Untrack().
+     *
+     * @return true if the area is tracked, false if there is no room for it
+     */
+    bool
+    Track( const TRenderArea& aRenderArea ) NOEXCEPT
+    {
+        for ( size_t i = 0; i < iAreasNumber; ++i )
+        {
+            if ( iAreas[ i ].iArea == &aRenderArea )
+            {
+                return true;
+            }
+        }
+        if ( iAreasNumber == taMaxAreas )
+        {
+            return false;
+        }
+        iAreas[ iAreasNumber++ ] = TTrackedArea{ &aRenderArea, false };
+        return true;
+    }
+
+    void
+    Untrack( const TRenderArea& aRenderArea ) NOEXCEPT
+    {
+        for ( size_t i = 0; i < iAreasNumber; ++i )
+        {
+            if ( iAreas[ i ].iArea == &aRenderArea )
+            {
+                iAreas[ i ] = iAreas[ --iAreasNumber ];
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Renders the area, restores the tracked areas left unknown by a previous recovery
+     * first.
+     *
+     * @param aRenderArea The render area to be rendered
+     * @param aSkippedBytes Receives the number of the display buffer bytes skipped as unchanged
+     * @return TErrorCode KOk on success, including the recovered faults, otherwise the error of
+     * the last retry
+     */
+    TErrorCode
+    Render( const TRenderArea& aRenderArea, size_t* aSkippedBytes = nullptr ) NOEXCEPT
+    {
+        using namespace AbstractPlatform;
+
+        auto result = RenderOnce( aRenderArea, aSkippedBytes );
+        if ( result == KOk )
+        {
+            return KOk;
+        }
+        OnFault( result );
+
+        std::uint32_t backoff = iPolicy.iInitialBackoff;
+        for ( std::uint8_t retry = 1; retry <= iPolicy.iMaxRetries; ++retry )
+        {
+            if ( iDelay != nullptr )
+            {
+                iDelay( backoff );
+            }
+            backoff = backoff > iPolicy.iMaxBackoff / 2 ? iPolicy.iMaxBackoff : backoff * 2;
+            ++iStatistics.iRetries;
+
+            result = retry >= iPolicy.iReinitRetry ? Reinit( ) : KOk;
+            if ( result == KOk )
+            {
+                result = RenderOnce( aRenderArea, aSkippedBytes );
+            }
+            if ( result == KOk )
+            {
+                ++iStatistics.iRecoveries;
+                return KOk;
+            }
+            OnFault( result );
+        }
+
+        ++iStatistics.iFailures;
+        return result;
+    }
+
+    /**
+     * @brief Re-initializes the controller and sends all the tracked areas again, e.g. after
+     * the panel has lost its power or the application has detected a corrupted image.
+     */
+    TErrorCode
+    Recover( ) NOEXCEPT
+    {
+        using namespace AbstractPlatform;
+
+        auto result = Reinit( );
+        if ( result == KOk )
+        {
+            result = RestoreUnknownAreas( );
+        }
+        if ( result != KOk )
+        {
+            OnFault( result );
+        }
+        return result;
+    }
+
+    inline const TStatistics&
+    Statistics( ) const NOEXCEPT
+    {
+        return iStatistics;
+    }
+
+    inline void
+    ResetStatistics( ) NOEXCEPT
+    {
+        iStatistics = TStatistics{ };
+    }
+
+private:
+    struct TTrackedArea
+    {
+        const TRenderArea* iArea;
+        // The display RAM content of the area is unknown, the area has to be sent completely
+        bool iUnknown;
+    };
+
+    inline void
+    OnFault( TErrorCode aError ) NOEXCEPT
+    {
+        ++iStatistics.iFaults;
+        iStatistics.iLastError = aError;
+        iSynchronized = false;
+    }
+
+    /**
+     * @brief Completes the command possibly cut by the failed transaction before sending any
+     * other one.
+     */
+    TErrorCode
+    Synchronize( ) NOEXCEPT
+    {
+        if ( !iSynchronized )
+        {
+            RETURN_ON_ERROR( iDisplay.Hal( ).SynchronizeCommands( ) );
+            iSynchronized = true;
+        }
+        return AbstractPlatform::KOk;
+    }
+
+    TErrorCode
+    RenderOnce( const TRenderArea& aRenderArea, size_t* aSkippedBytes ) NOEXCEPT
+    {
+        RETURN_ON_ERROR( Synchronize( ) );
+        RETURN_ON_ERROR( RestoreUnknownAreas( ) );
+        return iDisplay.Render( aRenderArea, aSkippedBytes );
+    }
+
+    /**
+     * @brief Configures the controller without clearing its RAM and marks all the tracked
+     * areas unknown.
+     */
+    TErrorCode
+    Reinit( ) NOEXCEPT
+    {
+        ++iStatistics.iReinits;
+        for ( size_t i = 0; i < iAreasNumber; ++i )
+        {
+            iAreas[ i ].iUnknown = true;
+        }
+        RETURN_ON_ERROR( Synchronize( ) );
+        return iDisplay.Init( false );
+    }
+
+    TErrorCode
+    RestoreUnknownAreas( ) NOEXCEPT
+    {
+        for ( size_t i = 0; i < iAreasNumber; ++i )
+        {
+            auto& tracked = iAreas[ i ];
+            if ( !tracked.iUnknown )
+            {
+                continue;
+            }
+
+            const auto& area = *tracked.iArea;
+            iDisplay.RestoreDirtyRegion(
+                area, typename TSsd1306::TRegion{
+                          0, static_cast< std::uint8_t >( area.Columns( ) - 1 ), 0,
+                          static_cast< std::uint8_t >( area.Rows( ) - 1 ) } );
+            RETURN_ON_ERROR( iDisplay.Render( area ) );
+            tracked.iUnknown = false;
+            ++iStatistics.iRestoredAreas;
+        }
+        return AbstractPlatform::KOk;
+    }
+
+    TSsd1306& iDisplay;
+    const TDelay iDelay;
+    TRecoveryPolicy iPolicy;
+    TTrackedArea iAreas[ taMaxAreas ];
+    size_t iAreasNumber;
+    TStatistics iStatistics;
+    // No command has been cut by a failed transaction since the last synchronization
+    bool iSynchronized;
+};
+}  // namespace Ssd1306
+}  // namespace ExternalHardware
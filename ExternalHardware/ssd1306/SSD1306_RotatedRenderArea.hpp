@@ -0,0 +1,233 @@
+#pragma once
+#include <AbstractPlatform/common/Platform.hpp>
+#include <AbstractPlatform/common/ErrorCode.hpp>
+#include <ExternalHardware/ssd1306/SSD1306.hpp>
+#include <ExternalHardware/ssd1306/SSD1306_BitmapConversion.hpp>
+
+#include <cassert>
+#include <cstdint>
+
+namespace ExternalHardware
+{
+namespace Ssd1306
+{
+/**
+ * @brief The clockwise rotation of the image relative to the panel.
+ */
+enum class TRotation : std::uint8_t
+{
+    Rotate0,
+    Rotate90,
+    Rotate180,
+    Rotate270
+};
+
+/**
+ * @brief Full screen render area drawn in the coordinates of the rotated and optionally mirrored
+ * panel. Every orientation is a composition of the image transpose (mirroring along the main
+ * diagonal) and the column and row mirrorings, which the controller does for free with the
+ * segment remap and the COM scan direction. So 0 and 180 degrees with or without mirroring cost
+ * no CPU work: the canvas is sent as it is. 90 and 270 degrees draw on a canvas with the width
+ * and height swapped, which is transposed into the display buffer at render time. The transpose
+ * works on 8x8 pixel blocks, each being 8 column bytes of a canvas page turned into 8 column
+ * bytes of a display page by CBitmapConversion::TransposeBits(), and covers only the blocks of
+ * the canvas dirty region.
+ *
+ * The remap applies to the whole panel, the area is meant to be the only content of the
+ * display. Call ApplyOrientation() once, the HAL keeps the mirroring over the re-initializations.
+ *
+ * @tparam taDisplayType The display type
+ * @tparam taRotation The clockwise image rotation
+ * @tparam taMirrored Mirror the image horizontally before rotating it
+ */
+template < typename taDisplayType = Ssd1306128x32,
+           TRotation taRotation = TRotation::Rotate0,
+           bool taMirrored = false >
+class CSsd1306RotatedRenderArea
+{
+public:
+    using TSsd1306 = CSsd1306< taDisplayType >;
+    using TSsd1306Hal = typename TSsd1306::TSsd1306Hal;
+    using TRenderArea = typename TSsd1306::CRenderAreaBase;
+    using TPage = typename TSsd1306::TPage;
+    using TErrorCode = AbstractPlatform::TErrorCode;
+
+    static constexpr bool KTransposed
+        = taRotation == TRotation::Rotate90 || taRotation == TRotation::Rotate270;
+    // The hardware part of the orientation, applied after the transpose
+    static constexpr bool KMirrorHorizontal = KTransposed ? taRotation == TRotation::Rotate90
+                                                          : ( taRotation == TRotation::Rotate180 )
+                                                                != taMirrored;
+    static constexpr bool KMirrorVertical = KTransposed ? ( taRotation == TRotation::Rotate270 )
+                                                              != taMirrored
+                                                        : taRotation == TRotation::Rotate180;
+    // The canvas size in the rotated coordinates
+    static constexpr std::uint8_t KPixelWidth
+        = KTransposed ? TSsd1306Hal::KPixelHight : TSsd1306Hal::KPixelWidth;
+    static constexpr std::uint8_t KPixelHight
+        = KTransposed ? TSsd1306Hal::KPixelWidth : TSsd1306Hal::KPixelHight;
+
+    static_assert( !KTransposed
+                       || ( TSsd1306Hal::KPixelWidth % TSsd1306Hal::KPixelsPerPage == 0
+                            && TSsd1306Hal::KPixelHight % TSsd1306Hal::KPixelsPerPage == 0 ),
+                   "The transposed panel size must be a multiple of the 8x8 blocks" );
+
+    CSsd1306RotatedRenderArea( ) NOEXCEPT
+        : iCanvasStorage{ }
+        , iDisplayStorage{ }
+        , iCanvas{ iCanvasStorage + KBufferAlignment }
+        , iDisplayArea{ 0,
+                        TSsd1306Hal::KMaxColumns - 1,
+                        0,
+                        TSsd1306Hal::KMaxPages - 1,
+                        KTransposed ? iDisplayStorage + KBufferAlignment
+                                    : iCanvasStorage + KBufferAlignment,
+                        true }
+    {
+    }
+
+    // The areas point into the inline storage, so the area can't be moved or copied
+    CSsd1306RotatedRenderArea( const CSsd1306RotatedRenderArea& ) = delete;
+    CSsd1306RotatedRenderArea& operator=( const CSsd1306RotatedRenderArea& ) = delete;
+
+    /**
+     * @brief The render area to draw on, KPixelWidth x KPixelHight pixels in the rotated
+     * coordinates. Render it only through Render() or DisplayArea().
+     */
+    inline TRenderArea&
+    Canvas( ) NOEXCEPT
+    {
+        return iCanvas;
+    }
+
+    inline const TRenderArea&
+    Canvas( ) const NOEXCEPT
+    {
+        return iCanvas;
+    }
+
+    /**
+     * @brief Sets the panel mirroring of the orientation and marks the whole area to be sent
+     * again, as the remap affects only the data written after it.
+     */
+    TErrorCode
+    ApplyOrientation( TSsd1306& aDisplay ) NOEXCEPT
+    {
+        RETURN_ON_ERROR( aDisplay.Hal( ).SetMirroring( KMirrorHorizontal, KMirrorVertical ) );
+        iCanvas.MarkAllDirty( );
+        return AbstractPlatform::KOk;
+    }
+
+    /**
+     * @brief Brings the canvas changes made since the previous call to the area in the display
+     * layout, which can then be sent by any renderer, e.g. the diff or the recovering one. The
+     * canvas itself is the display area for 0 and 180 degrees.
+     */
+    const TRenderArea&
+    DisplayArea( const TSsd1306& aDisplay ) NOEXCEPT
+    {
+        if ( !KTransposed )
+        {
+            return iCanvas;
+        }
+
+        typename TSsd1306::TRegion region;
+        if ( aDisplay.TakeDirtyRegion( iCanvas, region ) )
+        {
+            TransposeRegion( region );
+        }
+        return iDisplayArea;
+    }
+
+    /**
+     * @brief Sends the changes of the canvas to the display.
+     *
+     * @param aSkippedBytes Receives the number of the display buffer bytes skipped as unchanged
+     * @return TErrorCode KOk on success, otherwise the bus error. The changes are sent again by
+     * the next render on failure.
+     */
+    inline TErrorCode
+    Render( TSsd1306& aDisplay, size_t* aSkippedBytes = nullptr ) NOEXCEPT
+    {
+        return aDisplay.Render( DisplayArea( aDisplay ), aSkippedBytes );
+    }
+
+private:
+    static constexpr size_t KBufferAlignment = TSsd1306::KDefaultBufferAlignment;
+    static constexpr size_t KBlockSize = TSsd1306Hal::KPixelsPerPage;
+    static constexpr std::uint8_t KCanvasPages = KPixelHight / TSsd1306Hal::KPixelsPerPage;
+    static constexpr size_t KBufferSize
+        = static_cast< size_t >( TSsd1306Hal::KMaxColumns ) * TSsd1306Hal::KMaxPages;
+
+    /**
+     * @brief The render area over the canvas storage. Its size may exceed the display, which
+     * the public render areas don't allow.
+     */
+    class CCanvas : public TRenderArea
+    {
+    public:
+        explicit CCanvas( TPage* aBuffer ) NOEXCEPT
+            : TRenderArea{ 0, KPixelWidth - 1, 0, KCanvasPages - 1, aBuffer, true }
+        {
+        }
+    };
+
+    /**
+     * @brief Transposes the canvas blocks covering the region into the display buffer. The
+     * canvas column block b of the page p becomes the display columns 8p..8p+7 of the page b.
+     */
+    void
+    TransposeRegion( const typename TSsd1306::TRegion& aRegion ) NOEXCEPT
+    {
+        const std::uint8_t beginBlock = aRegion.iBeginColumn / KBlockSize;
+        const std::uint8_t lastBlock = aRegion.iLastColumn / KBlockSize;
+        const auto* canvas = iCanvasStorage + KBufferAlignment;
+        auto* display = iDisplayStorage + KBufferAlignment;
+
+        for ( std::uint8_t block = beginBlock; block <= lastBlock; ++block )
+        {
+            auto* row = display + block * TSsd1306Hal::KMaxColumns;
+            for ( std::uint8_t page = aRegion.iBeginPage; page <= aRegion.iLastPage; ++page )
+            {
+                const auto* source = canvas + page * KPixelWidth + block * KBlockSize;
+                StoreBlock( CBitmapConversion::TransposeBits( LoadBlock( source ) ),
+                            row + page * KBlockSize );
+            }
+        }
+
+        iDisplayArea.MarkDirty( static_cast< std::uint8_t >( aRegion.iBeginPage * KBlockSize ),
+                                static_cast< std::uint8_t >( aRegion.iLastPage * KBlockSize
+                                                             + KBlockSize - 1 ),
+                                beginBlock, lastBlock );
+    }
+
+    static inline std::uint64_t
+    LoadBlock( const TPage* aPages ) NOEXCEPT
+    {
+        std::uint64_t result = 0;
+        for ( size_t i = 0; i < KBlockSize; ++i )
+        {
+            result |= static_cast< std::uint64_t >( aPages[ i ] ) << ( i * 8 );
+        }
+        return result;
+    }
+
+    static inline void
+    StoreBlock( std::uint64_t aBlock, TPage* aPages ) NOEXCEPT
+    {
+        for ( size_t i = 0; i < KBlockSize; ++i, aBlock >>= 8 )
+        {
+            aPages[ i ] = static_cast< TPage >( aBlock );
+        }
+    }
+
+    // The headroom preceding each buffer takes as much as the alignment. The display buffer
+    // is needed only by the transposed orientations, the display area is the canvas otherwise.
+    alignas( KBufferAlignment ) TPage iCanvasStorage[ KBufferAlignment + KBufferSize ];
+    alignas( KBufferAlignment ) TPage iDisplayStorage[ KTransposed ? KBufferAlignment + KBufferSize
+                                                                   : 1 ];
+    CCanvas iCanvas;
+    typename TSsd1306::CExternalRenderArea iDisplayArea;
+};
+}  // namespace Ssd1306
+}  // namespace ExternalHardware
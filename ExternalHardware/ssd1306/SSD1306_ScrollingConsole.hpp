@@ -0,0 +1,124 @@
+#pragma once
+#include <AbstractPlatform/common/Platform.hpp>
+#include <AbstractPlatform/common/ErrorCode.hpp>
+#include <ExternalHardware/ssd1306/SSD1306.hpp>
+
+#include <cassert>
+#include <cstdint>
+
+namespace ExternalHardware
+{
+namespace Ssd1306
+{
+/**
+ * @brief Text console that scrolls by whole page rows using the display RAM as a ring buffer.
+ * A new line is written into the page row holding the oldest line and the display start line is
+ * moved past it, so a scroll costs one page row of data plus one command instead of a frame.
+ * The start line wraps around the whole controller RAM, so the ring spans all its pages and the
+ * lines of the panels lower than the RAM are written to the hidden pages before they scroll in.
+ *
+ * @note While the console is in use the display start line is shifted, so the regular render
+ * areas land at shifted rows. Reset() brings the start line back to 0.
+ */
+template < typename taDisplayType = Ssd1306128x32 >
+class CSsd1306ScrollingConsole
+{
+public:
+    using TSsd1306 = CSsd1306< taDisplayType >;
+    using TSsd1306Hal = typename TSsd1306::TSsd1306Hal;
+    using TRenderArea = typename TSsd1306::CRenderAreaBase;
+    using TPage = typename TSsd1306::TPage;
+    using TErrorCode = AbstractPlatform::TErrorCode;
+
+    // The one page high full width area a line can be drawn into before being pushed
+    using TLineArea = typename TSsd1306::template CStaticRenderArea< 0,
+                                                                    TSsd1306Hal::KMaxColumns - 1,
+                                                                    0,
+                                                                    0 >;
+
+    static constexpr std::uint8_t KLines = TSsd1306Hal::KMaxPages;
+    static constexpr std::uint8_t KRingRows = TSsd1306Hal::KRamPages;
+    static constexpr std::uint8_t KLineLength = TSsd1306Hal::KMaxColumns;
+
+    explicit CSsd1306ScrollingConsole( TSsd1306& aDisplay ) NOEXCEPT
+        : iDisplay{ aDisplay }
+        , iTopRow{ 0 }
+        , iLines{ 0 }
+    {
+    }
+
+    /**
+     * @brief Clears the display RAM and returns the start line to 0.
+     */
+    TErrorCode
+    Reset( ) NOEXCEPT
+    {
+        iTopRow = 0;
+        iLines = 0;
+        RETURN_ON_ERROR( iDisplay.Hal( ).ClearRam( ) );
+        return iDisplay.Hal( ).SetDisplayStartLine( 0 );
+    }
+
+    /**
+     * @brief Appends the line to the bottom of the console. The line fills the empty rows
+     * first, then the console scrolls up by one page row per line.
+     *
+     * @param aLine KLineLength column bytes of the new line
+     * @return TErrorCode KOk if succeed, otherwise appropriate error code
+     */
+    TErrorCode
+    PushLine( const TPage* aLine ) NOEXCEPT
+    {
+        assert( aLine != nullptr );
+
+        auto& hal = iDisplay.Hal( );
+        const bool scroll = iLines == KLines;
+        const auto row = static_cast< std::uint8_t >( ( iTopRow + iLines ) % KRingRows );
+
+        {
+            typename TSsd1306Hal::CCommandStream stream{ hal };
+            hal.SetColumnAddress( 0, KLineLength - 1 );
+            hal.SetPageAddress( row, row );
+            RETURN_ON_ERROR( hal.SendRamData( aLine, KLineLength ) );
+        }
+
+        if ( !scroll )
+        {
+            ++iLines;
+            return AbstractPlatform::KOk;
+        }
+
+        // The new row becomes the bottom one once the row after the top one is shown on top
+        iTopRow = static_cast< std::uint8_t >( ( iTopRow + 1 ) % KRingRows );
+        return hal.SetDisplayStartLine( StartLine( ) );
+    }
+
+    /**
+     * @brief Appends the line drawn in a one page high full width render area.
+     */
+    inline TErrorCode
+    PushLine( const TRenderArea& aLine ) NOEXCEPT
+    {
+        assert( aLine.Columns( ) == KLineLength );
+        assert( aLine.Rows( ) == 1 );
+        return PushLine( aLine.DisplayBuffer( ) );
+    }
+
+    /**
+     * @brief The display start line the console currently uses.
+     */
+    constexpr std::uint8_t
+    StartLine( ) const NOEXCEPT
+    {
+        return static_cast< std::uint8_t >( iTopRow * TSsd1306Hal::KPixelsPerPage );
+    }
+
+private:
+    TSsd1306& iDisplay;
+    // The RAM page shown at the top of the display
+    std::uint8_t iTopRow;
+    // The number of the lines pushed until the console got full
+    std::uint8_t iLines;
+};
+}  // namespace Ssd1306
+}  // namespace ExternalHardware
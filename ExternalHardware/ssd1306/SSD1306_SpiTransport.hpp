@@ -0,0 +1,138 @@
+#pragma once
+#include <AbstractPlatform/common/Platform.hpp>
+#include <AbstractPlatform/common/ErrorCode.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <cstddef>
+
+namespace ExternalHardware
+{
+namespace Ssd1306
+{
+/**
+ * @brief The SPI bus the display is attached to in the 4-wire mode, the chip select of the
+ * display being driven by the bus driver.
+ */
+class ISpiBus
+{
+public:
+    virtual ~ISpiBus( ) = default;
+
+    /**
+     * @brief Writes the bytes in one chip select frame, e.g. as one DMA transfer. Returns when
+     * the last byte has left the bus, as the D/C line is changed between the writes.
+     *
+     * @return int The number of the bytes written, negative on error
+     */
+    virtual int
+    Write( const std::uint8_t* aData, size_t aSize ) = 0;
+};
+
+/**
+ * @brief The D/C line of the display, a GPIO output telling the bytes written on the SPI bus
+ * to be the commands (low) or the RAM data (high).
+ */
+class IDataCommandLine
+{
+public:
+    virtual ~IDataCommandLine( ) = default;
+
+    virtual void
+    Set( bool aData ) = 0;
+};
+
+/**
+ * @brief The 4-wire SPI transport of the HAL. The controller samples the D/C line instead of
+ * reading the control bytes, so the HAL sends the command streams and the RAM data as they are:
+ * every command stream is one bulk write with the line low and every data chunk one bulk write
+ * with the line high, nothing is prefixed, copied or borrowed from the data. The line is driven
+ * only when the kind of the bytes changes.
+ *
+ * The SSD1306 takes up to 10 MHz of the serial clock, about 25 times the 400 kHz I2C. The
+ * transfer limits of the HAL default to no limit, so a whole frame goes in one write; set them
+ * to the longest DMA transfer of the bus driver if it has one.
+ */
+class CSsd1306SpiTransport
+{
+public:
+    using TErrorCode = AbstractPlatform::TErrorCode;
+
+    // The bytes are told apart by the D/C line
+    static constexpr bool KControlBytes = false;
+
+    /**
+     * @brief Construct the transport, the bus and the line must outlive it.
+     */
+    CSsd1306SpiTransport( ISpiBus& aSpiBus, IDataCommandLine& aDataCommandLine ) NOEXCEPT
+        : iSpiBus{ &aSpiBus },
+          iDataCommandLine{ &aDataCommandLine }
+    {
+    }
+
+    inline TErrorCode
+    WriteCommand( std::uint8_t aCommand ) NOEXCEPT
+    {
+        return WriteCommands( &aCommand, 1 );
+    }
+
+    /**
+     * @brief Writes the commands in one bulk write with the D/C line low.
+     */
+    inline TErrorCode
+    WriteCommands( const std::uint8_t* aCommands, size_t aSize ) NOEXCEPT
+    {
+        return Transfer( TLineState::Command, aCommands, aSize );
+    }
+
+    /**
+     * @brief Writes the RAM data in one bulk write with the D/C line high.
+     */
+    inline TErrorCode
+    WriteData( const std::uint8_t* aData, size_t aSize ) NOEXCEPT
+    {
+        return Transfer( TLineState::Data, aData, aSize );
+    }
+
+private:
+    enum class TLineState : std::uint8_t
+    {
+        Unknown,
+        Command,
+        Data
+    };
+
+    TErrorCode
+    Transfer( TLineState aLineState, const std::uint8_t* aBytes, size_t aSize ) NOEXCEPT
+    {
+        assert( aBytes != nullptr && aSize != 0 );
+
+        if ( iLineState != aLineState )
+        {
+            iDataCommandLine->Set( aLineState == TLineState::Data );
+            iLineState = aLineState;
+        }
+        return iSpiBus->Write( aBytes, aSize ) == static_cast< int >( aSize )
+                   ? AbstractPlatform::KOk
+                   : AbstractPlatform::KGenericError;
+    }
+
+    ISpiBus* iSpiBus;
+    IDataCommandLine* iDataCommandLine;
+    TLineState iLineState = TLineState::Unknown;
+};
+
+/**
+ * @brief The display type wired to the 4-wire SPI bus, e.g. CSsd1306< TSpiDisplay<
+ * Ssd1306128x64 > > constructed on a CSsd1306SpiTransport. All the drivers built on the display
+ * type, the renderers, the compositor, the marquee etc., go over the SPI then.
+ *
+ * @tparam taDisplayType The display type of the panel
+ */
+template < typename taDisplayType >
+struct TSpiDisplay : taDisplayType
+{
+    using TTransport = CSsd1306SpiTransport;
+};
+}  // namespace Ssd1306
+}  // namespace ExternalHardware
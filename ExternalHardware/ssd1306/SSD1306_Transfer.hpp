@@ -0,0 +1,112 @@
+#pragma once
+#include <AbstractPlatform/common/Platform.hpp>
+#include <AbstractPlatform/i2c/AbstractI2C.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <cstddef>
+
+namespace ExternalHardware
+{
+namespace Ssd1306
+{
+/**
+ * @brief A piece of a gathered bus transaction.
+ */
+struct TTransferSegment
+{
+    const std::uint8_t* iData;
+    size_t iSize;
+};
+
+/**
+ * @brief The I2C bus able to write one transaction gathered from several buffers, e.g. a bus
+ * driver chaining DMA descriptors or supporting the no-restart messages. The display driver
+ * uses it, when the bus given to it implements the interface, to prefix the data with the
+ * control bytes without copying the data.
+ */
+class IScatterGatherI2CBus : public AbstractPlatform::IAbstractI2CBus
+{
+public:
+    ~IScatterGatherI2CBus( ) override = default;
+
+    /**
+     * @brief Writes the segments as one transaction, as if they were a contiguous buffer.
+     *
+     * @return int The number of the bytes written, negative on error
+     */
+    virtual int
+    WriteGathered( std::uint8_t aAddress,
+                   const TTransferSegment* aSegments,
+                   size_t aSegmentsNumber,
+                   bool aNoStop = false )
+        = 0;
+};
+
+/**
+ * @brief The transfer abilities of the bus the display is attached to.
+ */
+struct TTransferLimits
+{
+    // The longest write accepted by the bus driver in bytes including the control bytes, e.g.
+    // 32 for the most MCU I2C stacks; 0 if unlimited
+    size_t iMaxTransferSize = 0;
+};
+
+/**
+ * @brief Splits the payloads into the transactions of the bus. The whole policy is the fewest
+ * transactions the transfer limit allows, with the payload spread evenly over them: every
+ * transaction pays the start, address and stop conditions, the driver setup and the header
+ * (the control byte and the commands going with the data), so fewer transactions are always
+ * faster, and the even split leaves no transaction with a few bytes.
+ */
+class CTransferPlanner
+{
+public:
+    constexpr explicit CTransferPlanner( TTransferLimits aLimits = TTransferLimits{ } ) NOEXCEPT
+        : iLimits{ aLimits }
+    {
+    }
+
+    constexpr const TTransferLimits&
+    Limits( ) const NOEXCEPT
+    {
+        return iLimits;
+    }
+
+    /**
+     * @brief The largest payload of a transaction carrying the header of the given size.
+     */
+    constexpr size_t
+    MaxChunkSize( size_t aHeaderSize ) const NOEXCEPT
+    {
+        return iLimits.iMaxTransferSize == 0 ? ~size_t{ 0 }
+                                             : iLimits.iMaxTransferSize - aHeaderSize;
+    }
+
+    /**
+     * @brief The number of the transactions sending the payload.
+     */
+    constexpr size_t
+    ChunksNumber( size_t aPayloadSize, size_t aHeaderSize ) const NOEXCEPT
+    {
+        return aPayloadSize == 0 ? 0
+                                 : ( aPayloadSize - 1 ) / MaxChunkSize( aHeaderSize ) + 1;
+    }
+
+    /**
+     * @brief The payload of every transaction but the last one, which may be shorter.
+     */
+    constexpr size_t
+    ChunkSize( size_t aPayloadSize, size_t aHeaderSize ) const NOEXCEPT
+    {
+        return aPayloadSize == 0
+                   ? 0
+                   : ( aPayloadSize - 1 ) / ChunksNumber( aPayloadSize, aHeaderSize ) + 1;
+    }
+
+private:
+    TTransferLimits iLimits;
+};
+}  // namespace Ssd1306
+}  // namespace ExternalHardware
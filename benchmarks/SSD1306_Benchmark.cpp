@@ -0,0 +1,817 @@
+#include <ExternalHardware/ssd1306/SSD1306.hpp>
+#include <ExternalHardware/ssd1306/SSD1306_BitmapConversion.hpp>
+#include <ExternalHardware/ssd1306/SSD1306_Compositor.hpp>
+#include <ExternalHardware/ssd1306/SSD1306_DiffRenderer.hpp>
+#include <ExternalHardware/ssd1306/SSD1306_Emulator.hpp>
+#include <ExternalHardware/ssd1306/SSD1306_Font.hpp>
+#include <ExternalHardware/ssd1306/SSD1306_GrayscaleRenderArea.hpp>
+#include <ExternalHardware/ssd1306/SSD1306_Marquee.hpp>
+#include <ExternalHardware/ssd1306/SSD1306_RotatedRenderArea.hpp>
+#include <ExternalHardware/ssd1306/SSD1306_SpiTransport.hpp>
+#if defined( __linux__ )
+#include <ExternalHardware/ssd1306/SSD1306_LinuxI2CBus.hpp>
+#endif
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+/**
+ * Runs the driver against the emulated display to report the bus cost of the operations (the
+ * transactions, the bytes on the wire and the simulated bus time at the given SCL clock) and
+ * against a bus accepting everything at once to report the CPU time spent by the driver itself.
+ * The grayscale cases report the bus and CPU load of holding the gray levels at 60 cycles per
+ * second. The rotated cases compare the text drawn pixel by pixel at the remapped coordinates
+ * with the one drawn on the rotated canvas and transposed at render time. The sprite scene
+ * cases move a sprite over a tile background under a text label, redrawing the whole render
+ * area every frame or letting the compositor send the changed cells. The marquee cases scroll
+ * a label through the bottom pages a column every 2 panel frames, by the controller scroll
+ * engine or by sending the shifted band from the software. The chunked cases
+ * render full frames through the bus drivers limiting the transfer size, gathering the control
+ * bytes or sending the chunks in place. The Linux cases count the i2c-dev system calls per
+ * frame with a transaction per call and with the render batched into I2C_RDWR calls. The SPI
+ * cases compare the I2C bus time with the bulk writes of the 4-wire SPI at 10 MHz.
+ *
+ * Usage: external-devices.ssd1306.benchmark [SCL clock in Hz]
+ */
+
+namespace
+{
+using namespace ExternalHardware::Ssd1306;
+
+using TDisplayType = Ssd1306128x64;
+using TSsd1306 = CSsd1306< TDisplayType >;
+using TSsd1306Hal = TSsd1306::TSsd1306Hal;
+using TEmulator = CSsd1306Emulator< TDisplayType >;
+using TDiffRenderer = CSsd1306DiffRenderer< TDisplayType >;
+using TRotatedRenderArea = CSsd1306RotatedRenderArea< TDisplayType, TRotation::Rotate90 >;
+using TCompositor = CSsd1306Compositor< TDisplayType >;
+using TMarquee = CSsd1306Marquee< TDisplayType >;
+using TSpiSsd1306 = CSsd1306< TSpiDisplay< TDisplayType > >;
+
+constexpr size_t KIterations = 200;
+constexpr size_t KGrayCyclesPerSecond = 60;
+constexpr size_t KBitmapStride = TSsd1306Hal::KPixelWidth / 8;
+constexpr std::uint32_t KSpiClock = 10000000;
+
+// A synthetic 16 pixels high monospaced font of the printable ASCII characters
+constexpr std::uint8_t KFontFirstCharacter = 32;
+constexpr std::uint8_t KFontLastCharacter = 126;
+constexpr size_t KFontGlyphs = KFontLastCharacter - KFontFirstCharacter + 1;
+constexpr std::uint8_t KGlyphWidth = 7;
+constexpr std::uint8_t KFontHeight = 16;
+constexpr std::uint8_t KFontPages = KFontHeight / 8;
+constexpr char KText[] = "Temp 21.5C H40%";
+// Fits the width of the display rotated by 90 degrees
+constexpr char KShortText[] = "21.5C";
+constexpr size_t KTiles = 4;
+constexpr std::uint8_t KSpriteSize = 16;
+constexpr int KSpriteY = 28;
+constexpr std::uint16_t KMarqueeColumns = 100;
+constexpr std::uint8_t KMarqueePage = TSsd1306Hal::KMaxPages - KFontPages;
+
+// The marquee clock, advanced by a panel frame every iteration of the marquee cases
+std::uint32_t gMarqueeTime = 0;
+
+std::uint32_t
+MarqueeClock( )
+{
+    return gMarqueeTime;
+}
+
+// Accepts every transaction at once, isolates the driver CPU time from the emulation
+class CNullBus : public AbstractPlatform::IAbstractI2CBus
+{
+public:
+    int
+    Read( std::uint8_t, std::uint8_t*, size_t aLength, bool ) override
+    {
+        return static_cast< int >( aLength );
+    }
+
+    int
+    Write( std::uint8_t, const std::uint8_t*, size_t aLength, bool ) override
+    {
+        return static_cast< int >( aLength );
+    }
+};
+
+// Passes the transactions to the emulator but can't gather them
+class CContiguousBus : public AbstractPlatform::IAbstractI2CBus
+{
+public:
+    explicit CContiguousBus( TEmulator& aEmulator )
+        : iEmulator{ aEmulator }
+    {
+    }
+
+    int
+    Read( std::uint8_t aAddress, std::uint8_t* aDst, size_t aLength, bool aNoStop ) override
+    {
+        return iEmulator.Read( aAddress, aDst, aLength, aNoStop );
+    }
+
+    int
+    Write( std::uint8_t aAddress, const std::uint8_t* aSrc, size_t aLength, bool aNoStop ) override
+    {
+        return iEmulator.Write( aAddress, aSrc, aLength, aNoStop );
+    }
+
+private:
+    TEmulator& iEmulator;
+};
+
+// The SPI bus and the D/C line of the emulated display, the bytes are passed to it in the
+// transactions opened by the control byte matching the line
+class CEmulatedSpiBus : public ISpiBus, public IDataCommandLine
+{
+public:
+    explicit CEmulatedSpiBus( TEmulator& aEmulator )
+        : iEmulator{ aEmulator }
+        , iData{ false }
+        , iWrites{ 0 }
+        , iBytes{ 0 }
+    {
+    }
+
+    void
+    Set( bool aData ) override
+    {
+        iData = aData;
+    }
+
+    int
+    Write( const std::uint8_t* aData, size_t aSize ) override
+    {
+        ++iWrites;
+        iBytes += aSize;
+        const std::uint8_t controlByte = iData ? TSsd1306Hal::KCmdSetRamBuffer
+                                               : TSsd1306Hal::KCmdStreamControlByte;
+        const TTransferSegment segments[] = { { &controlByte, 1 }, { aData, aSize } };
+        return iEmulator.WriteGathered( TSsd1306Hal::KDefaultAddress, segments, 2 ) < 0
+                   ? -1
+                   : static_cast< int >( aSize );
+    }
+
+    TEmulator& iEmulator;
+    bool iData;
+    size_t iWrites;
+    size_t iBytes;
+};
+
+#if defined( __linux__ )
+// The i2c-dev device of the adapter the emulated display is attached to, counts the system calls
+class CEmulatedI2CDev : public ILinuxI2CSyscalls
+{
+public:
+    explicit CEmulatedI2CDev( TEmulator& aEmulator )
+        : iEmulator{ aEmulator }
+        , iIoctls{ 0 }
+        , iMessages{ 0 }
+    {
+    }
+
+    int
+    Open( const char*, int ) override
+    {
+        return KFileDescriptor;
+    }
+
+    int
+    Close( int ) override
+    {
+        return 0;
+    }
+
+    int
+    Ioctl( int aFileDescriptor, unsigned long aRequest, void* aArgument ) override
+    {
+        ++iIoctls;
+        if ( aFileDescriptor != KFileDescriptor )
+        {
+            return -1;
+        }
+        if ( aRequest == I2C_FUNCS )
+        {
+            *static_cast< unsigned long* >( aArgument ) = I2C_FUNC_I2C | I2C_FUNC_NOSTART;
+            return 0;
+        }
+        if ( aRequest != I2C_RDWR )
+        {
+            return -1;
+        }
+
+        // A message starts a transaction unless it is a continuation, the transactions but the
+        // last one end with a repeated start
+        const auto& transfer = *static_cast< i2c_rdwr_ioctl_data* >( aArgument );
+        TTransferSegment segments[ CLinuxI2CBus::KMaxMessages ];
+        size_t segmentsNumber = 0;
+        for ( __u32 i = 0; i < transfer.nmsgs; ++i )
+        {
+            const auto& message = transfer.msgs[ i ];
+            const bool last = i + 1 == transfer.nmsgs;
+            ++iMessages;
+            if ( ( message.flags & I2C_M_RD ) != 0 )
+            {
+                if ( iEmulator.Read( static_cast< std::uint8_t >( message.addr ), message.buf,
+                                     message.len, !last )
+                     < 0 )
+                {
+                    return -1;
+                }
+                continue;
+            }
+
+            segments[ segmentsNumber++ ] = TTransferSegment{ message.buf, message.len };
+            if ( last || ( transfer.msgs[ i + 1 ].flags & I2C_M_NOSTART ) == 0 )
+            {
+                if ( iEmulator.WriteGathered( static_cast< std::uint8_t >( message.addr ),
+                                              segments, segmentsNumber, !last )
+                     < 0 )
+                {
+                    return -1;
+                }
+                segmentsNumber = 0;
+            }
+        }
+        return static_cast< int >( transfer.nmsgs );
+    }
+
+    TEmulator& iEmulator;
+    size_t iIoctls;
+    size_t iMessages;
+
+private:
+    static constexpr int KFileDescriptor = 3;
+};
+#endif
+
+// The state shared by the iterations of a case
+struct TFixture
+{
+    explicit TFixture( TSsd1306& aDisplay )
+        : iDisplay{ aDisplay }
+        , iDiffRenderer{ aDisplay }
+        , iTiles{ }
+        , iTileMap{ iTiles }
+        , iMarquee{ aDisplay,
+                    MarqueeClock,
+                    0,
+                    TSsd1306Hal::KMaxColumns - 1,
+                    KMarqueePage,
+                    TSsd1306Hal::KMaxPages - 1 }
+        , iFrame{ 0 }
+    {
+        std::srand( 1 );
+        for ( auto& byte : iBitmap )
+        {
+            byte = static_cast< std::uint8_t >( std::rand( ) );
+        }
+        for ( auto& byte : iGlyphBitmaps )
+        {
+            byte = static_cast< std::uint8_t >( std::rand( ) );
+        }
+        for ( size_t i = 0; i < KFontGlyphs; ++i )
+        {
+            iGlyphs[ i ] = TGlyph{ static_cast< std::uint32_t >( i * KGlyphWidth * KFontPages ),
+                                   KGlyphWidth, 0, KGlyphWidth + 1 };
+        }
+        iFont = TFont{ KFontHeight,        KFontPages, KFontHeight - 3, KFontFirstCharacter,
+                       KFontLastCharacter, '?',        iGlyphs,         iGlyphBitmaps,
+                       nullptr,            0 };
+
+        for ( auto& byte : iTiles )
+        {
+            byte = static_cast< std::uint8_t >( std::rand( ) );
+        }
+        for ( auto& byte : iSpriteImage )
+        {
+            byte = static_cast< std::uint8_t >( std::rand( ) );
+        }
+        for ( std::uint8_t row = 0; row < TCompositor::KCellRows; ++row )
+        {
+            for ( std::uint8_t column = 0; column < TCompositor::KCellColumns; ++column )
+            {
+                iTileMap.SetTile( column, row, TileAt( column, row ) );
+            }
+        }
+        iSprites.SetSprite( 0, TCompositor::TSprite{ 0, KSpriteY, KSpriteSize, KSpriteSize,
+                                                     iSpriteImage, nullptr, true } );
+        iLabels.SetText( 0, iFont, 0, 0, KText );
+        iCompositor.AddLayer( iTileMap );
+        iCompositor.AddLayer( iSprites );
+        iCompositor.AddLayer( iLabels );
+
+        for ( auto& byte : iMarqueeContent )
+        {
+            byte = static_cast< std::uint8_t >( std::rand( ) );
+        }
+    }
+
+    /**
+     * @brief Starts the marquee at the first frame and advances the clock by a panel frame.
+     */
+    void
+    RunMarquee( bool aHardwareAllowed )
+    {
+        if ( iFrame == 0 )
+        {
+            TMarquee::TMotion motion{ true, 2 * TMarquee::KDefaultFramePeriod };
+            motion.iGap = TSsd1306Hal::KMaxColumns - KMarqueeColumns;
+            motion.iHardwareAllowed = aHardwareAllowed;
+            iMarquee.Start( iMarqueeContent, KMarqueeColumns, motion );
+        }
+        gMarqueeTime += TMarquee::KDefaultFramePeriod;
+        iMarquee.Update( );
+    }
+
+    static constexpr std::uint8_t
+    TileAt( std::uint8_t aColumn, std::uint8_t aRow )
+    {
+        return static_cast< std::uint8_t >( ( aColumn + aRow ) % KTiles );
+    }
+
+    /**
+     * @brief Draws the whole sprite scene into the render area, the baseline of the compositor.
+     */
+    void
+    DrawScene( int aSpriteX )
+    {
+        for ( std::uint8_t row = 0; row < TCompositor::KCellRows; ++row )
+        {
+            for ( std::uint8_t column = 0; column < TCompositor::KCellColumns; ++column )
+            {
+                iArea.DrawPageBitmap( column * TCompositor::KCellWidth,
+                                      row * TSsd1306Hal::KPixelsPerPage, TCompositor::KCellWidth,
+                                      TSsd1306Hal::KPixelsPerPage,
+                                      iTiles + TileAt( column, row ) * TCompositor::KCellWidth,
+                                      TCompositor::KCellWidth );
+            }
+        }
+        iArea.DrawPageBitmap( aSpriteX, KSpriteY, KSpriteSize, KSpriteSize, iSpriteImage,
+                              KSpriteSize );
+        CTextRenderer::DrawText( iArea, iFont, 0, 0, KText );
+    }
+
+    /**
+     * @brief Draws the text pixel by pixel through the canvas interface, the baseline of the
+     * page-native text rendering.
+     *
+     * @param aRotated Rotate the text clockwise by 90 degrees by remapping every pixel position
+     */
+    void
+    DrawTextPixels( int aX, int aY, const char* aText, bool aRotated = false )
+    {
+        for ( const char* character = aText; *character != '\0'; ++character )
+        {
+            const auto& glyph = CTextRenderer::Glyph( iFont,
+                                                      static_cast< std::uint8_t >( *character ) );
+            for ( int column = 0; column < glyph.iAdvance; ++column, ++aX )
+            {
+                for ( int y = 0; y < KFontHeight; ++y )
+                {
+                    const auto byte
+                        = column < glyph.iWidth
+                              ? iGlyphBitmaps[ glyph.iBitmapOffset + ( y / 8 ) * glyph.iWidth
+                                               + column ]
+                              : 0;
+                    if ( aRotated )
+                    {
+                        iArea.SetPosition( TSsd1306Hal::KPixelWidth - 1 - aY - y, aX );
+                    }
+                    else
+                    {
+                        iArea.SetPosition( aX, aY + y );
+                    }
+                    iArea.SetPixel( { ( ( byte >> ( y % 8 ) ) & 1u ) != 0 } );
+                }
+            }
+        }
+    }
+
+    TSsd1306& iDisplay;
+    TSsd1306::CFullScreenRenderArea iArea;
+    TRotatedRenderArea iRotatedArea;
+    TDiffRenderer iDiffRenderer;
+    std::uint8_t iBitmap[ KBitmapStride * TSsd1306Hal::KPixelHight ];
+    std::uint8_t iPages[ TSsd1306Hal::KRamSize ];
+    std::uint8_t iGlyphBitmaps[ KFontGlyphs * KGlyphWidth * KFontPages ];
+    TGlyph iGlyphs[ KFontGlyphs ];
+    TFont iFont;
+    std::uint8_t iTiles[ KTiles * TCompositor::KCellWidth ];
+    std::uint8_t iSpriteImage[ KSpriteSize * KSpriteSize / 8 ];
+    TCompositor::CTileMapLayer iTileMap;
+    TCompositor::CSpriteLayer< 1 > iSprites;
+    TCompositor::CTextLayer< 1 > iLabels;
+    TCompositor iCompositor;
+    std::uint8_t iMarqueeContent[ KMarqueeColumns * KFontPages ];
+    TMarquee iMarquee;
+    size_t iFrame;
+};
+
+template < typename taCase >
+void
+Run( const char* aName, std::uint32_t aClock, taCase&& aCase )
+{
+    TEmulator emulator{ TSsd1306Hal::KDefaultAddress, aClock };
+    {
+        TSsd1306 display{ emulator };
+        TFixture fixture{ display };
+        display.Init( );
+        emulator.ResetStatistics( );
+        for ( size_t i = 0; i < KIterations; ++i, ++fixture.iFrame )
+        {
+            aCase( fixture );
+        }
+    }
+
+    CNullBus nullBus;
+    TSsd1306 display{ nullBus };
+    TFixture fixture{ display };
+    display.Init( );
+    const auto start = std::chrono::steady_clock::now( );
+    for ( size_t i = 0; i < KIterations; ++i, ++fixture.iFrame )
+    {
+        aCase( fixture );
+    }
+    const auto cpuTimeNs = std::chrono::duration_cast< std::chrono::nanoseconds >(
+                               std::chrono::steady_clock::now( ) - start )
+                               .count( );
+
+    const auto& statistics = emulator.Statistics( );
+    const double busTimeUs = emulator.BusTimeNs( ) / 1000.0 / KIterations;
+    const double cpuTimeUs = cpuTimeNs / 1000.0 / KIterations;
+    const double frameTimeUs = busTimeUs + cpuTimeUs;
+    std::printf( "%-28s %8.1f %10.1f %12.1f %10.2f %10.1f\n", aName,
+                 static_cast< double >( statistics.iTransactions ) / KIterations,
+                 static_cast< double >( statistics.iWireBytes ) / KIterations, busTimeUs,
+                 cpuTimeUs, frameTimeUs > 0 ? 1000000.0 / frameTimeUs : 0.0 );
+}
+/**
+ * @brief Cycles the gray levels of a test image: a horizontal gradient over the upper half of
+ * the display, a white box and a black background.
+ */
+template < std::uint8_t taBitsPerPixel >
+void
+RunGrayscale( const char* aName,
+              std::uint32_t aClock,
+              typename CSsd1306GrayscaleRenderArea< TDisplayType,
+                                                    taBitsPerPixel >::TModulation aModulation )
+{
+    using TGrayscaleRenderArea = CSsd1306GrayscaleRenderArea< TDisplayType, taBitsPerPixel >;
+
+    const auto drawImage = []( TGrayscaleRenderArea& aArea ) {
+        const int width = aArea.PixelWidth( );
+        const int height = aArea.PixelHeight( );
+        for ( int x = 0; x < width; ++x )
+        {
+            const auto level = static_cast< std::uint8_t >(
+                x * ( TGrayscaleRenderArea::KMaxLevel + 1 ) / width );
+            aArea.FillRectangle( x, 0, 1, height / 2, level );
+        }
+        aArea.FillRectangle( width / 4, height * 5 / 8, width / 2, height / 4,
+                             TGrayscaleRenderArea::KMaxLevel );
+    };
+
+    TEmulator emulator{ TSsd1306Hal::KDefaultAddress, aClock };
+    size_t cycles = 0;
+    {
+        TSsd1306 display{ emulator };
+        TDiffRenderer renderer{ display };
+        TGrayscaleRenderArea area{ aModulation };
+        display.Init( );
+        drawImage( area );
+        // The first cycle sends the image, the steady state is measured
+        for ( size_t i = 0; i < area.SubframesPerCycle( ); ++i )
+        {
+            area.RenderSubframe( renderer );
+        }
+        emulator.ResetStatistics( );
+        cycles = KIterations / area.SubframesPerCycle( );
+        for ( size_t i = 0; i < cycles * area.SubframesPerCycle( ); ++i )
+        {
+            area.RenderSubframe( renderer );
+        }
+    }
+
+    CNullBus nullBus;
+    TSsd1306 display{ nullBus };
+    TDiffRenderer renderer{ display };
+    TGrayscaleRenderArea area{ aModulation };
+    display.Init( );
+    drawImage( area );
+    const auto start = std::chrono::steady_clock::now( );
+    for ( size_t i = 0; i < cycles * area.SubframesPerCycle( ); ++i )
+    {
+        area.RenderSubframe( renderer );
+    }
+    const auto cpuTimeNs = std::chrono::duration_cast< std::chrono::nanoseconds >(
+                               std::chrono::steady_clock::now( ) - start )
+                               .count( );
+
+    const auto& statistics = emulator.Statistics( );
+    const double bytesPerSecond
+        = static_cast< double >( statistics.iWireBytes ) / cycles * KGrayCyclesPerSecond;
+    const double busLoad = emulator.BusTimeNs( ) / 1e9 / cycles * KGrayCyclesPerSecond;
+    const double cpuLoad = cpuTimeNs / 1e9 / cycles * KGrayCyclesPerSecond;
+    std::printf( "%-28s %6u %10zu %12.0f %9.1f%% %9.2f%%\n", aName,
+                 TGrayscaleRenderArea::KMaxLevel + 1u,
+                 area.SubframesPerCycle( ) * KGrayCyclesPerSecond, bytesPerSecond,
+                 busLoad * 100.0, cpuLoad * 100.0 );
+}
+
+#if defined( __linux__ )
+/**
+ * @brief Runs the case on the i2c-dev bus of the emulated display with a system call per
+ * transaction and with every iteration batched.
+ */
+template < typename taCase >
+void
+RunLinux( const char* aName, std::uint32_t aClock, taCase&& aCase )
+{
+    double ioctls[ 2 ];
+    double messages = 0;
+    double wireBytes = 0;
+    for ( const bool batched : { false, true } )
+    {
+        TEmulator emulator{ TSsd1306Hal::KDefaultAddress, aClock };
+        CEmulatedI2CDev device{ emulator };
+        CLinuxI2CBus bus{ device };
+        bus.Open( "/dev/i2c-1" );
+        TSsd1306 display{ bus };
+        display.Hal( ).SetTransferLimits( CLinuxI2CBus::Limits( ) );
+        TFixture fixture{ display };
+        display.Init( );
+        emulator.ResetStatistics( );
+        device.iIoctls = 0;
+        device.iMessages = 0;
+        for ( size_t i = 0; i < KIterations; ++i, ++fixture.iFrame )
+        {
+            CLinuxI2CBus::CBatch batch{ bus };
+            if ( !batched )
+            {
+                batch.Commit( );
+            }
+            aCase( fixture );
+        }
+        ioctls[ batched ] = static_cast< double >( device.iIoctls ) / KIterations;
+        messages = static_cast< double >( device.iMessages ) / KIterations;
+        wireBytes = static_cast< double >( emulator.Statistics( ).iWireBytes ) / KIterations;
+    }
+    std::printf( "%-28s %10.1f %10.1f %10.1f %12.1f\n", aName, ioctls[ 0 ], ioctls[ 1 ],
+                 messages, wireBytes );
+}
+#endif
+
+/**
+ * @brief Runs the case on the I2C display and on the same display attached to the SPI bus.
+ *
+ * @param aCase Called with the display and its full screen render area for every iteration
+ */
+template < typename taCase >
+void
+RunSpi( const char* aName, std::uint32_t aClock, taCase&& aCase )
+{
+    TEmulator i2cEmulator{ TSsd1306Hal::KDefaultAddress, aClock };
+    TSsd1306 i2cDisplay{ i2cEmulator };
+    TSsd1306::CFullScreenRenderArea i2cArea;
+    i2cDisplay.Init( );
+    i2cEmulator.ResetStatistics( );
+    for ( size_t i = 0; i < KIterations; ++i )
+    {
+        aCase( i2cDisplay, i2cArea, i );
+    }
+
+    TEmulator spiEmulator{ TSsd1306Hal::KDefaultAddress, aClock };
+    CEmulatedSpiBus spiBus{ spiEmulator };
+    TSpiSsd1306 spiDisplay{ CSsd1306SpiTransport{ spiBus, spiBus } };
+    TSpiSsd1306::CFullScreenRenderArea spiArea;
+    spiDisplay.Init( );
+    spiBus.iWrites = 0;
+    spiBus.iBytes = 0;
+    for ( size_t i = 0; i < KIterations; ++i )
+    {
+        aCase( spiDisplay, spiArea, i );
+    }
+
+    const double spiBytes = static_cast< double >( spiBus.iBytes ) / KIterations;
+    std::printf( "%-28s %12.1f %10.1f %10.1f %12.1f\n", aName,
+                 i2cEmulator.BusTimeNs( ) / 1000.0 / KIterations,
+                 static_cast< double >( spiBus.iWrites ) / KIterations, spiBytes,
+                 spiBytes * 8 * 1000000.0 / KSpiClock );
+}
+
+/**
+ * @brief Renders full frames through the bus driver accepting at most aMaxTransferSize bytes
+ * per transaction.
+ */
+void
+RunChunked( const char* aName, std::uint32_t aClock, size_t aMaxTransferSize, bool aGather )
+{
+    TEmulator emulator{ TSsd1306Hal::KDefaultAddress, aClock };
+    CContiguousBus contiguousBus{ emulator };
+    emulator.SetMaxTransferSize( aMaxTransferSize );
+
+    TSsd1306 gatheringDisplay{ emulator };
+    TSsd1306 contiguousDisplay{ contiguousBus };
+    TSsd1306& display = aGather ? gatheringDisplay : contiguousDisplay;
+    display.Hal( ).SetTransferLimits( TTransferLimits{ aMaxTransferSize } );
+    TFixture fixture{ display };
+    display.Init( );
+    emulator.ResetStatistics( );
+    for ( size_t i = 0; i < KIterations; ++i )
+    {
+        fixture.iArea.MarkAllDirty( );
+        display.Render( fixture.iArea );
+    }
+
+    // The chunk really sent, which the driver may make smaller than the planned one to copy it
+    const auto& statistics = emulator.Statistics( );
+    std::printf( "%-28s %8u %10.1f %12.1f %12.1f %8u\n", aName,
+                 statistics.iMaxTransactionDataBytes,
+                 static_cast< double >( statistics.iTransactions ) / KIterations,
+                 static_cast< double >( statistics.iWireBytes ) / KIterations,
+                 emulator.BusTimeNs( ) / 1000.0 / KIterations, statistics.iNacks );
+}
+}  // namespace
+
+int
+main( int aArgc, char** aArgv )
+{
+    const std::uint32_t clock
+        = aArgc > 1 ? static_cast< std::uint32_t >( std::strtoul( aArgv[ 1 ], nullptr, 10 ) )
+                    : TEmulator::KDefaultClock;
+    if ( clock == 0 )
+    {
+        std::fprintf( stderr, "Invalid SCL clock\n" );
+        return EXIT_FAILURE;
+    }
+
+    std::printf( "SSD1306 %ux%u, SCL %u Hz, %zu iterations per case\n",
+                 TSsd1306Hal::KPixelWidth, TSsd1306Hal::KPixelHight, clock, KIterations );
+    std::printf( "%-28s %8s %10s %12s %10s %10s\n", "Case", "Tx/op", "Bytes/op", "Bus us/op",
+                 "CPU us/op", "Max op/s" );
+
+    Run( "Init", clock, []( TFixture& aFixture ) { aFixture.iDisplay.Init( ); } );
+    Run( "ClearRam", clock,
+         []( TFixture& aFixture ) { aFixture.iDisplay.Hal( ).ClearRam( ); } );
+    Run( "Render full frame", clock, []( TFixture& aFixture ) {
+        aFixture.iArea.MarkAllDirty( );
+        aFixture.iDisplay.Render( aFixture.iArea );
+    } );
+    Run( "Render one pixel", clock, []( TFixture& aFixture ) {
+        aFixture.iArea.SetPosition( static_cast< int >( aFixture.iFrame % 128 ),
+                                    static_cast< int >( aFixture.iFrame % 64 ) );
+        aFixture.iArea.SetPixel( { ( aFixture.iFrame & 1 ) != 0 } );
+        aFixture.iDisplay.Render( aFixture.iArea );
+    } );
+    Run( "Render 32x16 region", clock, []( TFixture& aFixture ) {
+        aFixture.iDisplay.RenderRegion( aFixture.iArea, 48, 79, 3, 4 );
+    } );
+    Run( "Render external frame", clock, []( TFixture& aFixture ) {
+        TSsd1306::CExternalRenderArea area{ 0, TSsd1306Hal::KMaxColumns - 1, 0,
+                                            TSsd1306Hal::KMaxPages - 1, aFixture.iPages };
+        aFixture.iDisplay.Render( area );
+    } );
+    Run( "Render image", clock, []( TFixture& aFixture ) {
+        aFixture.iDisplay.RenderImage( aFixture.iPages, 0, TSsd1306Hal::KMaxColumns - 1, 0,
+                                       TSsd1306Hal::KMaxPages - 1 );
+    } );
+    Run( "Diff render moving 8x8", clock, []( TFixture& aFixture ) {
+        const int x = static_cast< int >( aFixture.iFrame % 120 );
+        aFixture.iArea.FillWith( { false } );
+        aFixture.iArea.FillRectangle( x, 28, 8, 8, { true } );
+        aFixture.iDiffRenderer.Render( aFixture.iArea );
+    } );
+    Run( "Draw SetPixel frame", clock, []( TFixture& aFixture ) {
+        for ( int y = 0; y < TSsd1306Hal::KPixelHight; ++y )
+        {
+            for ( int x = 0; x < TSsd1306Hal::KPixelWidth; ++x )
+            {
+                const auto phase = static_cast< int >( aFixture.iFrame );
+                aFixture.iArea.SetPosition( x, y );
+                aFixture.iArea.SetPixel( { ( ( x ^ y ^ phase ) & 1 ) != 0 } );
+            }
+        }
+    } );
+    Run( "Draw FillRectangle", clock, []( TFixture& aFixture ) {
+        aFixture.iArea.FillRectangle( static_cast< int >( aFixture.iFrame % 16 ), 3, 100, 50,
+                                      { ( aFixture.iFrame & 1 ) != 0 } );
+    } );
+    Run( "Draw bitmap frame", clock, []( TFixture& aFixture ) {
+        aFixture.iArea.DrawBitmap( 0, 0, TSsd1306Hal::KPixelWidth, TSsd1306Hal::KPixelHight,
+                                   aFixture.iBitmap, KBitmapStride );
+    } );
+    Run( "Convert bitmap frame", clock, []( TFixture& aFixture ) {
+        CBitmapConversion::ConvertFrame( aFixture.iBitmap, KBitmapStride,
+                                         TSsd1306Hal::KPixelWidth, TSsd1306Hal::KPixelHight,
+                                         aFixture.iPages );
+    } );
+    Run( "Draw text SetPixel", clock,
+         []( TFixture& aFixture ) { aFixture.DrawTextPixels( 0, 16, KText ); } );
+    Run( "Draw text page aligned", clock, []( TFixture& aFixture ) {
+        CTextRenderer::DrawText( aFixture.iArea, aFixture.iFont, 0, 16, KText );
+    } );
+    Run( "Draw text unaligned", clock, []( TFixture& aFixture ) {
+        CTextRenderer::DrawText( aFixture.iArea, aFixture.iFont, 0, 19, KText );
+    } );
+    Run( "Draw and render text", clock, []( TFixture& aFixture ) {
+        CTextRenderer::DrawText( aFixture.iArea, aFixture.iFont, 0, 16, KText );
+        aFixture.iDisplay.Render( aFixture.iArea );
+    } );
+    Run( "Render rotated 90 frame", clock, []( TFixture& aFixture ) {
+        aFixture.iRotatedArea.Canvas( ).MarkAllDirty( );
+        aFixture.iRotatedArea.Render( aFixture.iDisplay );
+    } );
+    Run( "Text SetPixel remapped 90", clock, []( TFixture& aFixture ) {
+        aFixture.DrawTextPixels( static_cast< int >( aFixture.iFrame % 16 ), 16, KShortText,
+                                 true );
+        aFixture.iDisplay.Render( aFixture.iArea );
+    } );
+    Run( "Text on rotated 90 canvas", clock, []( TFixture& aFixture ) {
+        CTextRenderer::DrawText( aFixture.iRotatedArea.Canvas( ), aFixture.iFont,
+                                 static_cast< int >( aFixture.iFrame % 16 ), 16, KShortText );
+        aFixture.iRotatedArea.Render( aFixture.iDisplay );
+    } );
+    Run( "Sprite scene full redraw", clock, []( TFixture& aFixture ) {
+        aFixture.DrawScene( static_cast< int >( aFixture.iFrame % 112 ) );
+        aFixture.iDisplay.Render( aFixture.iArea );
+    } );
+    Run( "Sprite scene compositor", clock, []( TFixture& aFixture ) {
+        aFixture.iSprites.MoveSprite( 0, static_cast< int >( aFixture.iFrame % 112 ), KSpriteY );
+        aFixture.iCompositor.Render( aFixture.iDisplay );
+    } );
+    Run( "Marquee hardware scroll", clock,
+         []( TFixture& aFixture ) { aFixture.RunMarquee( true ); } );
+    Run( "Marquee software scroll", clock,
+         []( TFixture& aFixture ) { aFixture.RunMarquee( false ); } );
+
+    using TGray2 = CSsd1306GrayscaleRenderArea< TDisplayType, 2 >;
+    using TGray4 = CSsd1306GrayscaleRenderArea< TDisplayType, 4 >;
+    std::printf( "\nGrayscale at %zu cycles/s\n", KGrayCyclesPerSecond );
+    std::printf( "%-28s %6s %10s %12s %10s %10s\n", "Case", "Levels", "Subframe/s", "Bytes/s",
+                 "Bus load", "CPU load" );
+    RunGrayscale< 2 >( "Gray 2bpp temporal", clock, TGray2::TModulation::Temporal );
+    RunGrayscale< 2 >( "Gray 2bpp contrast", clock, TGray2::TModulation::Contrast );
+    RunGrayscale< 4 >( "Gray 4bpp temporal", clock, TGray4::TModulation::Temporal );
+    RunGrayscale< 4 >( "Gray 4bpp contrast", clock, TGray4::TModulation::Contrast );
+
+    std::printf( "\nChunked full frame render\n" );
+    std::printf( "%-28s %8s %10s %12s %12s %8s\n", "Case", "Chunk", "Tx/frame", "Bytes/frame",
+                 "Bus us/frame", "NACKs" );
+    RunChunked( "Unlimited", clock, 0, false );
+    RunChunked( "4096 byte limit in place", clock, 4096, false );
+    RunChunked( "255 byte limit in place", clock, 255, false );
+    RunChunked( "255 byte limit gathered", clock, 255, true );
+    RunChunked( "32 byte limit in place", clock, 32, false );
+    RunChunked( "32 byte limit gathered", clock, 32, true );
+    RunChunked( "16 byte limit in place", clock, 16, false );
+
+    std::printf( "\nSPI at %u Hz\n", KSpiClock );
+    std::printf( "%-28s %12s %10s %10s %12s\n", "Case", "I2C us/op", "Writes/op", "Bytes/op",
+                 "SPI us/op" );
+    RunSpi( "Init", clock, []( auto& aDisplay, auto&, size_t ) { aDisplay.Init( ); } );
+    RunSpi( "Render full frame", clock, []( auto& aDisplay, auto& aArea, size_t ) {
+        aArea.MarkAllDirty( );
+        aDisplay.Render( aArea );
+    } );
+    RunSpi( "Render one pixel", clock, []( auto& aDisplay, auto& aArea, size_t aFrame ) {
+        aArea.SetPosition( static_cast< int >( aFrame % 128 ), static_cast< int >( aFrame % 64 ) );
+        aArea.SetPixel( { ( aFrame & 1 ) != 0 } );
+        aDisplay.Render( aArea );
+    } );
+    RunSpi( "Render 32x16 region", clock, []( auto& aDisplay, auto& aArea, size_t ) {
+        aDisplay.RenderRegion( aArea, 48, 79, 3, 4 );
+    } );
+
+#if defined( __linux__ )
+    std::printf( "\nLinux i2c-dev system calls per frame\n" );
+    std::printf( "%-28s %10s %10s %10s %12s\n", "Case", "Unbatched", "Batched", "Messages",
+                 "Bytes/frame" );
+    RunLinux( "Init", clock, []( TFixture& aFixture ) { aFixture.iDisplay.Init( ); } );
+    RunLinux( "Render full frame", clock, []( TFixture& aFixture ) {
+        aFixture.iArea.MarkAllDirty( );
+        aFixture.iDisplay.Render( aFixture.iArea );
+    } );
+    RunLinux( "Render 32x16 region", clock, []( TFixture& aFixture ) {
+        aFixture.iDisplay.RenderRegion( aFixture.iArea, 48, 79, 3, 4 );
+    } );
+    RunLinux( "Diff render moving 8x8", clock, []( TFixture& aFixture ) {
+        const int x = static_cast< int >( aFixture.iFrame % 120 );
+        aFixture.iArea.FillWith( { false } );
+        aFixture.iArea.FillRectangle( x, 28, 8, 8, { true } );
+        aFixture.iDiffRenderer.Render( aFixture.iArea );
+    } );
+    RunLinux( "Draw and render text", clock, []( TFixture& aFixture ) {
+        CTextRenderer::DrawText( aFixture.iArea, aFixture.iFont, 0, 16, KText );
+        aFixture.iDisplay.Render( aFixture.iArea );
+    } );
+    RunLinux( "Sprite scene compositor", clock, []( TFixture& aFixture ) {
+        aFixture.iSprites.MoveSprite( 0, static_cast< int >( aFixture.iFrame % 112 ), KSpriteY );
+        aFixture.iCompositor.Render( aFixture.iDisplay );
+    } );
+#endif
+
+    return EXIT_SUCCESS;
+}
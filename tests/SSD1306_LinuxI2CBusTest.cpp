@@ -0,0 +1,353 @@
+#include <ExternalHardware/ssd1306/SSD1306.hpp>
+#include <ExternalHardware/ssd1306/SSD1306_LinuxI2CBus.hpp>
+
+#include "SSD1306_TestCheck.hpp"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Checks the I2C_RDWR message lists CLinuxI2CBus hands to the kernel, by running it on a fake
+ * i2c-dev recording every ioctl: the batched renders going in one system call, the batch split
+ * at the message and the queue limits, the deferred batch errors and the I2C_M_NOSTART
+ * continuations of the gathered writes.
+ *
+ * Usage: external-devices.ssd1306.linux-i2c-bus-test
+ */
+
+namespace
+{
+using namespace ExternalHardware::Ssd1306;
+
+using TSsd1306 = CSsd1306< Ssd1306128x64 >;
+using TSsd1306Hal = TSsd1306::TSsd1306Hal;
+
+// A message of a recorded I2C_RDWR call
+struct TMessage
+{
+    std::uint16_t iAddress;
+    std::uint16_t iFlags;
+    const std::uint8_t* iBuffer;
+    std::vector< std::uint8_t > iData;
+};
+
+// The i2c-dev recording the I2C_RDWR calls, fails the one given
+class CFakeI2CDev : public ILinuxI2CSyscalls
+{
+public:
+    explicit CFakeI2CDev( unsigned long aFunctionality = I2C_FUNC_I2C )
+        : iFunctionality{ aFunctionality }
+    {
+    }
+
+    int
+    Open( const char*, int ) override
+    {
+        return KFileDescriptor;
+    }
+
+    int
+    Close( int ) override
+    {
+        return 0;
+    }
+
+    int
+    Ioctl( int aFileDescriptor, unsigned long aRequest, void* aArgument ) override
+    {
+        if ( aFileDescriptor != KFileDescriptor )
+        {
+            return -1;
+        }
+        if ( aRequest == I2C_FUNCS )
+        {
+            *static_cast< unsigned long* >( aArgument ) = iFunctionality;
+            return 0;
+        }
+        if ( aRequest != I2C_RDWR )
+        {
+            return -1;
+        }
+
+        const auto& transfer = *static_cast< i2c_rdwr_ioctl_data* >( aArgument );
+        std::vector< TMessage > messages;
+        for ( __u32 i = 0; i < transfer.nmsgs; ++i )
+        {
+            const auto& message = transfer.msgs[ i ];
+            messages.push_back( TMessage{ message.addr, message.flags, message.buf,
+                                          { message.buf, message.buf + message.len } } );
+        }
+        iCalls.push_back( messages );
+        return iCalls.size( ) == iFailingCall ? -1 : static_cast< int >( transfer.nmsgs );
+    }
+
+    static constexpr int KFileDescriptor = 3;
+
+    const unsigned long iFunctionality;
+    // The number of the I2C_RDWR call failing, counting from 1, or 0 if none fails
+    size_t iFailingCall = 0;
+    std::vector< std::vector< TMessage > > iCalls;
+};
+
+size_t
+MessagesNumber( const CFakeI2CDev& aDevice )
+{
+    size_t result = 0;
+    for ( const auto& call : aDevice.iCalls )
+    {
+        result += call.size( );
+    }
+    return result;
+}
+
+void
+TestBatchedRenderIsOneCall( )
+{
+    CFakeI2CDev device;
+    CLinuxI2CBus bus{ device };
+    CHECK( bus.Open( "/dev/i2c-1" ) == AbstractPlatform::KOk );
+    TSsd1306 display{ bus };
+    display.Hal( ).SetTransferLimits( CLinuxI2CBus::Limits( ) );
+
+    {
+        CLinuxI2CBus::CBatch batch{ bus };
+        CHECK( display.Init( ) == AbstractPlatform::KOk );
+        CHECK( batch.Commit( ) == AbstractPlatform::KOk );
+    }
+    CHECK( device.iCalls.size( ) == 1 );
+
+    TSsd1306::CFullScreenRenderArea area;
+    area.FillRectangle( 0, 0, TSsd1306Hal::KPixelWidth, TSsd1306Hal::KPixelHight, { true } );
+    device.iCalls.clear( );
+    {
+        CLinuxI2CBus::CBatch batch{ bus };
+        CHECK( display.Render( area ) == AbstractPlatform::KOk );
+        CHECK( batch.Commit( ) == AbstractPlatform::KOk );
+    }
+
+    // The address windows command stream and the frame data
+    CHECK( device.iCalls.size( ) == 1 );
+    if ( device.iCalls.size( ) == 1 && device.iCalls[ 0 ].size( ) == 2 )
+    {
+        const auto& commands = device.iCalls[ 0 ][ 0 ];
+        const auto& data = device.iCalls[ 0 ][ 1 ];
+        CHECK( commands.iAddress == TSsd1306Hal::KDefaultAddress );
+        CHECK( commands.iData.front( ) == TSsd1306Hal::KCmdStreamControlByte );
+        CHECK( data.iData.size( ) == TSsd1306Hal::KRamSize + 1 );
+        CHECK( data.iData.front( ) == TSsd1306Hal::KCmdSetRamBuffer );
+        CHECK( data.iData.back( ) == 0xFF );
+        CHECK( data.iFlags == 0 );
+    }
+    else
+    {
+        CHECK( !"Render is expected to be two messages of one call" );
+    }
+
+    // Several bursts of a region render still go in one call
+    device.iCalls.clear( );
+    {
+        CLinuxI2CBus::CBatch batch{ bus };
+        CHECK( display.RenderRegion( area, 48, 79, 3, 4 ) == AbstractPlatform::KOk );
+        CHECK( display.RenderRegion( area, 0, 7, 0, 7 ) == AbstractPlatform::KOk );
+    }
+    CHECK( device.iCalls.size( ) == 1 );
+    CHECK( MessagesNumber( device ) >= 4 );
+}
+
+void
+TestBatchSplitsAtMessageLimit( )
+{
+    CFakeI2CDev device;
+    CLinuxI2CBus bus{ device };
+    CHECK( bus.Open( "/dev/i2c-1" ) == AbstractPlatform::KOk );
+
+    const std::uint8_t write[] = { 0x00, 0xE3 };
+    {
+        CLinuxI2CBus::CBatch batch{ bus };
+        for ( size_t i = 0; i < CLinuxI2CBus::KMaxMessages + 1; ++i )
+        {
+            CHECK( bus.Write( 0x3C, write, sizeof( write ) ) == sizeof( write ) );
+        }
+        // Nothing but the full message list has been sent so far
+        CHECK( device.iCalls.size( ) == 1 );
+        CHECK( batch.Commit( ) == AbstractPlatform::KOk );
+    }
+
+    CHECK( CLinuxI2CBus::KMaxMessages == 42 );
+    CHECK( device.iCalls.size( ) == 2 );
+    if ( device.iCalls.size( ) == 2 )
+    {
+        CHECK( device.iCalls[ 0 ].size( ) == CLinuxI2CBus::KMaxMessages );
+        CHECK( device.iCalls[ 1 ].size( ) == 1 );
+    }
+}
+
+void
+TestBatchSplitsAtQueueCapacity( )
+{
+    CFakeI2CDev device;
+    CLinuxI2CBus bus{ device };
+    CHECK( bus.Open( "/dev/i2c-1" ) == AbstractPlatform::KOk );
+
+    // Two writes fit the queue, the third one doesn't
+    static std::uint8_t write[ CLinuxI2CBus::KBatchCapacity / 2 - 8 ];
+    for ( size_t i = 0; i < sizeof( write ); ++i )
+    {
+        write[ i ] = static_cast< std::uint8_t >( i );
+    }
+    {
+        CLinuxI2CBus::CBatch batch{ bus };
+        for ( size_t i = 0; i < 3; ++i )
+        {
+            CHECK( bus.Write( 0x3C, write, sizeof( write ) ) == sizeof( write ) );
+        }
+    }
+
+    CHECK( device.iCalls.size( ) == 2 );
+    if ( device.iCalls.size( ) == 2 )
+    {
+        CHECK( device.iCalls[ 0 ].size( ) == 2 );
+        CHECK( device.iCalls[ 1 ].size( ) == 1 );
+        // The queued writes are copies
+        CHECK( device.iCalls[ 1 ][ 0 ].iBuffer != write );
+        CHECK( device.iCalls[ 1 ][ 0 ].iData
+               == std::vector< std::uint8_t >( write, write + sizeof( write ) ) );
+    }
+
+    // A write longer than the queue is rejected
+    static std::uint8_t tooLong[ CLinuxI2CBus::KBatchCapacity + 1 ];
+    CLinuxI2CBus::CBatch batch{ bus };
+    CHECK( bus.Write( 0x3C, tooLong, sizeof( tooLong ) ) < 0 );
+}
+
+void
+TestDeferredBatchError( )
+{
+    CFakeI2CDev device;
+    CLinuxI2CBus bus{ device };
+    CHECK( bus.Open( "/dev/i2c-1" ) == AbstractPlatform::KOk );
+    device.iFailingCall = 1;
+
+    const std::uint8_t write[] = { 0x00, 0xE3 };
+    {
+        // The error is reported at the end of the batch, the writes succeed when queued
+        CLinuxI2CBus::CBatch batch{ bus };
+        CHECK( bus.Write( 0x3C, write, sizeof( write ) ) == sizeof( write ) );
+        CHECK( bus.Write( 0x3C, write, sizeof( write ) ) == sizeof( write ) );
+        CHECK( device.iCalls.empty( ) );
+        CHECK( batch.Commit( ) == AbstractPlatform::KGenericError );
+    }
+    CHECK( device.iCalls.size( ) == 1 );
+
+    device.iCalls.clear( );
+    {
+        // The flush failing in the middle of the batch fails the rest of its writes
+        CLinuxI2CBus::CBatch batch{ bus };
+        for ( size_t i = 0; i < CLinuxI2CBus::KMaxMessages; ++i )
+        {
+            CHECK( bus.Write( 0x3C, write, sizeof( write ) ) == sizeof( write ) );
+        }
+        CHECK( bus.Write( 0x3C, write, sizeof( write ) ) < 0 );
+        CHECK( bus.Write( 0x3C, write, sizeof( write ) ) < 0 );
+        CHECK( batch.Commit( ) == AbstractPlatform::KGenericError );
+    }
+    CHECK( device.iCalls.size( ) == 1 );
+
+    // The next batch starts clean
+    device.iCalls.clear( );
+    device.iFailingCall = 0;
+    {
+        CLinuxI2CBus::CBatch batch{ bus };
+        CHECK( bus.Write( 0x3C, write, sizeof( write ) ) == sizeof( write ) );
+        CHECK( batch.Commit( ) == AbstractPlatform::KOk );
+    }
+    CHECK( device.iCalls.size( ) == 1 );
+}
+
+void
+TestGatheredWrites( )
+{
+    const std::uint8_t header[] = { TSsd1306Hal::KCmdSetRamBuffer };
+    const std::uint8_t data[] = { 0x01, 0x02, 0x03 };
+    const TTransferSegment segments[] = { { header, sizeof( header ) }, { data, sizeof( data ) } };
+    const std::vector< std::uint8_t > joined = { TSsd1306Hal::KCmdSetRamBuffer, 0x01, 0x02, 0x03 };
+
+    {
+        // The segments go without copying as the I2C_M_NOSTART continuations
+        CFakeI2CDev device{ I2C_FUNC_I2C | I2C_FUNC_NOSTART };
+        CLinuxI2CBus bus{ device };
+        CHECK( bus.Open( "/dev/i2c-1" ) == AbstractPlatform::KOk );
+        CHECK( bus.NoStartSupported( ) );
+        CHECK( bus.WriteGathered( 0x3C, segments, 2 ) == 4 );
+        CHECK( device.iCalls.size( ) == 1 );
+        if ( device.iCalls.size( ) == 1 && device.iCalls[ 0 ].size( ) == 2 )
+        {
+            const auto& messages = device.iCalls[ 0 ];
+            CHECK( messages[ 0 ].iFlags == 0 );
+            CHECK( messages[ 0 ].iBuffer == header );
+            CHECK( messages[ 1 ].iFlags == I2C_M_NOSTART );
+            CHECK( messages[ 1 ].iBuffer == data );
+            CHECK( messages[ 1 ].iAddress == 0x3C );
+        }
+        else
+        {
+            CHECK( !"The gathered write is expected to be two messages of one call" );
+        }
+
+        // The batch queues the segments as one message
+        device.iCalls.clear( );
+        {
+            CLinuxI2CBus::CBatch batch{ bus };
+            CHECK( bus.WriteGathered( 0x3C, segments, 2 ) == 4 );
+        }
+        CHECK( device.iCalls.size( ) == 1 && device.iCalls[ 0 ].size( ) == 1
+               && device.iCalls[ 0 ][ 0 ].iData == joined );
+    }
+
+    {
+        // Lacking I2C_FUNC_NOSTART the segments are joined into one message
+        CFakeI2CDev device;
+        CLinuxI2CBus bus{ device };
+        CHECK( bus.Open( "/dev/i2c-1" ) == AbstractPlatform::KOk );
+        CHECK( !bus.NoStartSupported( ) );
+        CHECK( bus.WriteGathered( 0x3C, segments, 2 ) == 4 );
+        CHECK( device.iCalls.size( ) == 1 && device.iCalls[ 0 ].size( ) == 1
+               && device.iCalls[ 0 ][ 0 ].iFlags == 0
+               && device.iCalls[ 0 ][ 0 ].iData == joined );
+    }
+
+    {
+        // The render data chunks are gathered by the display driver
+        CFakeI2CDev device{ I2C_FUNC_I2C | I2C_FUNC_NOSTART };
+        CLinuxI2CBus bus{ device };
+        CHECK( bus.Open( "/dev/i2c-1" ) == AbstractPlatform::KOk );
+        TSsd1306 display{ bus };
+        TSsd1306::CFullScreenRenderArea area;
+        CHECK( display.RenderRegion( area, 8, 15, 2, 2 ) == AbstractPlatform::KOk );
+        CHECK( device.iCalls.size( ) == 2 );
+        if ( device.iCalls.size( ) == 2 && device.iCalls[ 1 ].size( ) == 2 )
+        {
+            CHECK( device.iCalls[ 1 ][ 0 ].iData
+                   == std::vector< std::uint8_t >{ TSsd1306Hal::KCmdSetRamBuffer } );
+            CHECK( device.iCalls[ 1 ][ 1 ].iFlags == I2C_M_NOSTART );
+            CHECK( device.iCalls[ 1 ][ 1 ].iData.size( ) == 8 );
+        }
+        else
+        {
+            CHECK( !"The region data is expected to be gathered from two messages" );
+        }
+    }
+}
+}  // namespace
+
+int
+main( )
+{
+    TestBatchedRenderIsOneCall( );
+    TestBatchSplitsAtMessageLimit( );
+    TestBatchSplitsAtQueueCapacity( );
+    TestDeferredBatchError( );
+    TestGatheredWrites( );
+
+    return Tests::TestResult( );
+}
@@ -0,0 +1,216 @@
+#include <ExternalHardware/ssd1306/SSD1306.hpp>
+#include <ExternalHardware/ssd1306/SSD1306_SpiTransport.hpp>
+
+#include "SSD1306_TestCheck.hpp"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Checks the writes and the D/C line changes of the SPI transport, by running the driver on a
+ * fake SPI bus recording them: the command streams going with the line low, the RAM data with
+ * the line high and without the data control byte, the line driven only when the kind of the
+ * bytes changes and the SH1106 page row pointer commands.
+ *
+ * Usage: external-devices.ssd1306.spi-transport-test
+ */
+
+namespace
+{
+using namespace ExternalHardware::Ssd1306;
+
+using TSsd1306 = CSsd1306< TSpiDisplay< Ssd1306128x64 > >;
+using TSh1106 = CSsd1306< TSpiDisplay< Sh1106128x64 > >;
+
+// A bulk write and the D/C line level it went with
+struct TWrite
+{
+    bool iData;
+    std::vector< std::uint8_t > iBytes;
+};
+
+// The SPI bus and the D/C line recording the writes and the line changes
+class CFakeSpiBus : public ISpiBus, public IDataCommandLine
+{
+public:
+    int
+    Write( const std::uint8_t* aData, size_t aSize ) override
+    {
+        iWrites.push_back( TWrite{ iLine, { aData, aData + aSize } } );
+        return static_cast< int >( aSize );
+    }
+
+    void
+    Set( bool aData ) override
+    {
+        ++iLineChanges;
+        // Setting the line to the level it already has is a redundant GPIO access
+        iRedundantLineChanges += iLineSet && iLine == aData ? 1 : 0;
+        iLineSet = true;
+        iLine = aData;
+    }
+
+    void
+    Clear( )
+    {
+        iWrites.clear( );
+        iLineChanges = 0;
+        iRedundantLineChanges = 0;
+    }
+
+    // The line changes the writes need, the first write needs the line set
+    size_t
+    KindChanges( bool aLineSetBefore ) const
+    {
+        size_t result = 0;
+        for ( size_t i = 0; i < iWrites.size( ); ++i )
+        {
+            if ( i == 0 ? !aLineSetBefore : iWrites[ i ].iData != iWrites[ i - 1 ].iData )
+            {
+                ++result;
+            }
+        }
+        return result;
+    }
+
+    std::vector< TWrite > iWrites;
+    bool iLine = false;
+    bool iLineSet = false;
+    size_t iLineChanges = 0;
+    size_t iRedundantLineChanges = 0;
+};
+
+void
+TestCommandsGoWithLineLow( )
+{
+    CFakeSpiBus bus;
+    TSsd1306 display{ CSsd1306SpiTransport{ bus, bus } };
+    CHECK( display.Init( false ) == AbstractPlatform::KOk );
+
+    // The init sequence and the display on command, no control byte in front
+    CHECK( bus.iWrites.size( ) == 1 );
+    if ( !bus.iWrites.empty( ) )
+    {
+        const auto& commands = bus.iWrites.front( );
+        CHECK( !commands.iData );
+        CHECK( commands.iBytes.front( ) == 0xAE );
+        CHECK( commands.iBytes.back( ) == 0xAF );
+    }
+
+    bus.Clear( );
+    CHECK( display.Hal( ).SetContrast( 0x20 ) == AbstractPlatform::KOk );
+    CHECK( bus.iWrites.size( ) == 1 );
+    if ( bus.iWrites.size( ) == 1 )
+    {
+        CHECK( !bus.iWrites[ 0 ].iData );
+        CHECK( bus.iWrites[ 0 ].iBytes == ( std::vector< std::uint8_t >{ 0x81, 0x20 } ) );
+    }
+}
+
+void
+TestDataGoesWithLineHigh( )
+{
+    CFakeSpiBus bus;
+    TSsd1306 display{ CSsd1306SpiTransport{ bus, bus } };
+    CHECK( display.Init( false ) == AbstractPlatform::KOk );
+
+    TSsd1306::CFullScreenRenderArea area;
+    area.FillRectangle( 0, 0, 64, 64, { true } );
+    bus.Clear( );
+    CHECK( display.Render( area ) == AbstractPlatform::KOk );
+
+    // The address windows with the line low, then the frame as it is with the line high
+    CHECK( bus.iWrites.size( ) == 2 );
+    if ( bus.iWrites.size( ) == 2 )
+    {
+        CHECK( !bus.iWrites[ 0 ].iData );
+        CHECK( bus.iWrites[ 0 ].iBytes
+               == ( std::vector< std::uint8_t >{ 0x21, 0x00, 0x7F, 0x22, 0x00, 0x07 } ) );
+        const auto& data = bus.iWrites[ 1 ];
+        CHECK( data.iData );
+        CHECK( data.iBytes.size( ) == TSsd1306::TSsd1306Hal::KRamSize );
+        CHECK( data.iBytes.front( ) == 0xFF );
+        CHECK( data.iBytes.back( ) == 0x00 );
+    }
+
+    // The region rows are sent as the data bytes only
+    bus.Clear( );
+    CHECK( display.RenderRegion( area, 60, 67, 2, 3 ) == AbstractPlatform::KOk );
+    CHECK( bus.iWrites.size( ) == 2 );
+    if ( bus.iWrites.size( ) == 2 )
+    {
+        const std::vector< std::uint8_t > row = { 0xFF, 0xFF, 0xFF, 0xFF, 0, 0, 0, 0 };
+        std::vector< std::uint8_t > expected = row;
+        expected.insert( expected.end( ), row.begin( ), row.end( ) );
+        CHECK( bus.iWrites[ 1 ].iData );
+        CHECK( bus.iWrites[ 1 ].iBytes == expected );
+    }
+}
+
+void
+TestLineChangesWithByteKind( )
+{
+    CFakeSpiBus bus;
+    TSsd1306 display{ CSsd1306SpiTransport{ bus, bus } };
+    CHECK( display.Init( ) == AbstractPlatform::KOk );
+    CHECK( bus.iLineChanges == bus.KindChanges( false ) );
+    CHECK( bus.iRedundantLineChanges == 0 );
+
+    TSsd1306::CFullScreenRenderArea area;
+    area.FillRectangle( 10, 10, 20, 20, { true } );
+    bus.Clear( );
+    CHECK( display.Hal( ).SetContrast( 0x20 ) == AbstractPlatform::KOk );
+    CHECK( display.Hal( ).SetDisplayStartLine( 0 ) == AbstractPlatform::KOk );
+    CHECK( display.RenderRegion( area, 10, 29, 1, 3 ) == AbstractPlatform::KOk );
+    CHECK( display.RenderRegion( area, 0, 127, 0, 0 ) == AbstractPlatform::KOk );
+    CHECK( display.Render( area ) == AbstractPlatform::KOk );
+
+    // The line has been left low by the display on command
+    CHECK( bus.iLineChanges == bus.KindChanges( true ) );
+    CHECK( bus.iRedundantLineChanges == 0 );
+    // The two commands share the line level
+    CHECK( bus.iWrites.size( ) > 4 && !bus.iWrites[ 0 ].iData && !bus.iWrites[ 1 ].iData );
+}
+
+void
+TestSh1106PointerCommands( )
+{
+    CFakeSpiBus bus;
+    TSh1106 display{ CSsd1306SpiTransport{ bus, bus } };
+    CHECK( display.Init( false ) == AbstractPlatform::KOk );
+
+    TSh1106::CFullScreenRenderArea area;
+    area.FillRectangle( 0, 0, 128, 64, { true } );
+    bus.Clear( );
+    CHECK( display.RenderRegion( area, 16, 23, 2, 3 ) == AbstractPlatform::KOk );
+
+    // Each page row: the page and the column pointers, low and high nibble of the RAM column
+    // shifted by the 2 column offset, then the row data
+    const std::vector< std::uint8_t > row( 8, 0xFF );
+    CHECK( bus.iWrites.size( ) == 4 );
+    if ( bus.iWrites.size( ) == 4 )
+    {
+        CHECK( !bus.iWrites[ 0 ].iData );
+        CHECK( bus.iWrites[ 0 ].iBytes == ( std::vector< std::uint8_t >{ 0xB2, 0x02, 0x11 } ) );
+        CHECK( bus.iWrites[ 1 ].iData );
+        CHECK( bus.iWrites[ 1 ].iBytes == row );
+        CHECK( !bus.iWrites[ 2 ].iData );
+        CHECK( bus.iWrites[ 2 ].iBytes == ( std::vector< std::uint8_t >{ 0xB3, 0x02, 0x11 } ) );
+        CHECK( bus.iWrites[ 3 ].iData );
+        CHECK( bus.iWrites[ 3 ].iBytes == row );
+    }
+    // The line has been left low by the display on command
+    CHECK( bus.iLineChanges == 3 );
+}
+}  // namespace
+
+int
+main( )
+{
+    TestCommandsGoWithLineLow( );
+    TestDataGoesWithLineHigh( );
+    TestLineChangesWithByteKind( );
+    TestSh1106PointerCommands( );
+
+    return Tests::TestResult( );
+}
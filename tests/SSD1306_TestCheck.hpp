@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+
+/**
+ * The checks of the driver tests. A failed check reports its condition and place and the test
+ * goes on, so a run lists every failure; the test exits with TestResult( ).
+ */
+
+namespace ExternalHardware
+{
+namespace Ssd1306
+{
+namespace Tests
+{
+// The failed checks of the test run
+inline size_t gFailures = 0;
+
+/**
+ * @brief Reports the run and returns the exit status of the test.
+ */
+inline int
+TestResult( )
+{
+    if ( gFailures != 0 )
+    {
+        std::fprintf( stderr, "%zu checks failed\n", gFailures );
+        return EXIT_FAILURE;
+    }
+    std::printf( "All checks passed\n" );
+    return EXIT_SUCCESS;
+}
+}  // namespace Tests
+}  // namespace Ssd1306
+}  // namespace ExternalHardware
+
+#define CHECK( aCondition )                                                                        \
+    do                                                                                             \
+    {                                                                                              \
+        if ( !( aCondition ) )                                                                     \
+        {                                                                                          \
+            std::fprintf( stderr, "%s:%d: CHECK( %s ) failed\n", __FILE__, __LINE__,              \
+                          #aCondition );                                                           \
+            ++ExternalHardware::Ssd1306::Tests::gFailures;                                         \
+        }                                                                                          \
+    } while ( false )
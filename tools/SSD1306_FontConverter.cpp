@@ -0,0 +1,383 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * Converts a BDF bitmap font to a header defining an ExternalHardware::Ssd1306::TFont with the
+ * glyphs in the SSD1306 page-major layout, ready to be blitted by CTextRenderer.
+ *
+ * Usage: external-devices.ssd1306.font-converter <font.bdf> <name> <output.hpp>
+ *            [--range <first>-<last>] [--default <character>] [--kerning <pairs.txt>]
+ *
+ * The characters are given by their codes. The kerning file has one pair per line, the left and
+ * the right character codes followed by the pen advance adjustment in pixels, the lines starting
+ * with # are ignored.
+ */
+
+namespace
+{
+constexpr int KPixelsPerPage = 8;
+
+struct TBdfGlyph
+{
+    int iEncoding = -1;
+    int iAdvance = 0;
+    int iWidth = 0;
+    int iHeight = 0;
+    int iXOffset = 0;
+    int iYOffset = 0;
+    std::vector< std::uint64_t > iRows;
+};
+
+struct TBdfFont
+{
+    int iAscent = 0;
+    int iDescent = 0;
+    std::vector< TBdfGlyph > iGlyphs;
+};
+
+struct TKerningPair
+{
+    int iLeft;
+    int iRight;
+    int iAdjustment;
+};
+
+bool
+ParseBdf( const char* aPath, TBdfFont& aFont )
+{
+    std::ifstream file{ aPath };
+    if ( !file )
+    {
+        std::fprintf( stderr, "Can't open %s\n", aPath );
+        return false;
+    }
+
+    int boundingBoxHeight = 0;
+    int boundingBoxYOffset = 0;
+    TBdfGlyph glyph;
+    bool inBitmap = false;
+    std::string line;
+    while ( std::getline( file, line ) )
+    {
+        std::istringstream fields{ line };
+        std::string keyword;
+        fields >> keyword;
+
+        if ( inBitmap )
+        {
+            if ( keyword == "ENDCHAR" )
+            {
+                inBitmap = false;
+                if ( glyph.iWidth > 64 || glyph.iAdvance < 0 || glyph.iAdvance > 255
+                     || glyph.iXOffset < -128 || glyph.iXOffset > 127 )
+                {
+                    std::fprintf( stderr, "Glyph %d metrics out of range\n", glyph.iEncoding );
+                    return false;
+                }
+                aFont.iGlyphs.push_back( glyph );
+                continue;
+            }
+            // The rows are hex numbers left aligned to whole bytes
+            const auto row = std::strtoull( keyword.c_str( ), nullptr, 16 );
+            const int bits = static_cast< int >( keyword.size( ) ) * 4;
+            glyph.iRows.push_back( bits > glyph.iWidth ? row >> ( bits - glyph.iWidth ) : row );
+        }
+        else if ( keyword == "FONTBOUNDINGBOX" )
+        {
+            int width = 0;
+            int xOffset = 0;
+            fields >> width >> boundingBoxHeight >> xOffset >> boundingBoxYOffset;
+        }
+        else if ( keyword == "FONT_ASCENT" )
+        {
+            fields >> aFont.iAscent;
+        }
+        else if ( keyword == "FONT_DESCENT" )
+        {
+            fields >> aFont.iDescent;
+        }
+        else if ( keyword == "STARTCHAR" )
+        {
+            glyph = TBdfGlyph{ };
+        }
+        else if ( keyword == "ENCODING" )
+        {
+            fields >> glyph.iEncoding;
+        }
+        else if ( keyword == "DWIDTH" )
+        {
+            fields >> glyph.iAdvance;
+        }
+        else if ( keyword == "BBX" )
+        {
+            fields >> glyph.iWidth >> glyph.iHeight >> glyph.iXOffset >> glyph.iYOffset;
+        }
+        else if ( keyword == "BITMAP" )
+        {
+            inBitmap = true;
+        }
+    }
+
+    if ( aFont.iAscent + aFont.iDescent == 0 )
+    {
+        aFont.iAscent = boundingBoxHeight + boundingBoxYOffset;
+        aFont.iDescent = -boundingBoxYOffset;
+    }
+    if ( aFont.iGlyphs.empty( ) || aFont.iAscent + aFont.iDescent <= 0 )
+    {
+        std::fprintf( stderr, "%s is not a BDF font\n", aPath );
+        return false;
+    }
+    return true;
+}
+
+bool
+ParseKerning( const char* aPath, std::vector< TKerningPair >& aPairs )
+{
+    std::ifstream file{ aPath };
+    if ( !file )
+    {
+        std::fprintf( stderr, "Can't open %s\n", aPath );
+        return false;
+    }
+
+    std::string line;
+    while ( std::getline( file, line ) )
+    {
+        if ( line.empty( ) || line[ 0 ] == '#' )
+        {
+            continue;
+        }
+        std::istringstream fields{ line };
+        TKerningPair pair{ };
+        if ( !( fields >> pair.iLeft >> pair.iRight >> pair.iAdjustment ) )
+        {
+            std::fprintf( stderr, "Invalid kerning pair: %s\n", line.c_str( ) );
+            return false;
+        }
+        if ( pair.iLeft < 0 || pair.iLeft > 255 || pair.iRight < 0 || pair.iRight > 255
+             || pair.iAdjustment < -128 || pair.iAdjustment > 127 )
+        {
+            std::fprintf( stderr, "Kerning pair out of range: %s\n", line.c_str( ) );
+            return false;
+        }
+        aPairs.push_back( pair );
+    }
+
+    std::sort( aPairs.begin( ), aPairs.end( ),
+               []( const TKerningPair& aLeft, const TKerningPair& aRight ) {
+                   return aLeft.iLeft != aRight.iLeft ? aLeft.iLeft < aRight.iLeft
+                                                      : aLeft.iRight < aRight.iRight;
+               } );
+    return true;
+}
+
+/**
+ * @brief Converts the glyph rows to the page rows covering the whole font height.
+ */
+std::vector< std::uint8_t >
+ConvertGlyph( const TBdfGlyph& aGlyph, int aAscent, int aHeight )
+{
+    const int pages = ( aHeight + KPixelsPerPage - 1 ) / KPixelsPerPage;
+    std::vector< std::uint8_t > bitmap( static_cast< size_t >( pages * aGlyph.iWidth ) );
+
+    // The BBX y offset is the distance of the glyph bottom from the baseline
+    const int top = aAscent - aGlyph.iYOffset - aGlyph.iHeight;
+    for ( int row = 0; row < static_cast< int >( aGlyph.iRows.size( ) ); ++row )
+    {
+        const int y = top + row;
+        if ( y < 0 || y >= aHeight )
+        {
+            continue;
+        }
+        for ( int column = 0; column < aGlyph.iWidth; ++column )
+        {
+            if ( ( aGlyph.iRows[ row ] >> ( aGlyph.iWidth - 1 - column ) ) & 1u )
+            {
+                bitmap[ ( y / KPixelsPerPage ) * aGlyph.iWidth + column ]
+                    |= static_cast< std::uint8_t >( 1u << ( y % KPixelsPerPage ) );
+            }
+        }
+    }
+    return bitmap;
+}
+}  // namespace
+
+int
+main( int aArgc, char** aArgv )
+{
+    if ( aArgc < 4 )
+    {
+        std::fprintf( stderr,
+                      "Usage: %s <font.bdf> <name> <output.hpp> [--range <first>-<last>] "
+                      "[--default <character>] [--kerning <pairs.txt>]\n",
+                      aArgv[ 0 ] );
+        return EXIT_FAILURE;
+    }
+
+    const char* fontPath = aArgv[ 1 ];
+    const std::string name = aArgv[ 2 ];
+    const char* outputPath = aArgv[ 3 ];
+    int firstCharacter = 32;
+    int lastCharacter = 126;
+    int defaultCharacter = '?';
+    const char* kerningPath = nullptr;
+    for ( int i = 4; i < aArgc; i += 2 )
+    {
+        if ( i + 1 == aArgc )
+        {
+            std::fprintf( stderr, "Missing the value of %s\n", aArgv[ i ] );
+            return EXIT_FAILURE;
+        }
+        if ( std::strcmp( aArgv[ i ], "--range" ) == 0
+             && std::sscanf( aArgv[ i + 1 ], "%d-%d", &firstCharacter, &lastCharacter ) == 2 )
+        {
+            continue;
+        }
+        if ( std::strcmp( aArgv[ i ], "--default" ) == 0 )
+        {
+            defaultCharacter = std::atoi( aArgv[ i + 1 ] );
+            continue;
+        }
+        if ( std::strcmp( aArgv[ i ], "--kerning" ) == 0 )
+        {
+            kerningPath = aArgv[ i + 1 ];
+            continue;
+        }
+        std::fprintf( stderr, "Invalid option %s\n", aArgv[ i ] );
+        return EXIT_FAILURE;
+    }
+    if ( firstCharacter < 0 || lastCharacter > 255 || firstCharacter > lastCharacter )
+    {
+        std::fprintf( stderr, "Invalid character range\n" );
+        return EXIT_FAILURE;
+    }
+
+    TBdfFont font;
+    std::vector< TKerningPair > kerningPairs;
+    if ( !ParseBdf( fontPath, font )
+         || ( kerningPath != nullptr && !ParseKerning( kerningPath, kerningPairs ) ) )
+    {
+        return EXIT_FAILURE;
+    }
+
+    const int height = font.iAscent + font.iDescent;
+    if ( height > 255 )
+    {
+        std::fprintf( stderr, "The font is too high\n" );
+        return EXIT_FAILURE;
+    }
+
+    const auto findGlyph = [ &font ]( int aEncoding ) -> const TBdfGlyph* {
+        for ( const auto& glyph : font.iGlyphs )
+        {
+            if ( glyph.iEncoding == aEncoding )
+            {
+                return &glyph;
+            }
+        }
+        return nullptr;
+    };
+    if ( defaultCharacter < firstCharacter || defaultCharacter > lastCharacter
+         || findGlyph( defaultCharacter ) == nullptr )
+    {
+        defaultCharacter = findGlyph( firstCharacter ) != nullptr ? firstCharacter : -1;
+    }
+    if ( defaultCharacter < 0 )
+    {
+        std::fprintf( stderr, "No default glyph in the range\n" );
+        return EXIT_FAILURE;
+    }
+
+    // The bitmaps of the glyphs present in the font, the missing characters share the bitmap
+    // of the default glyph
+    std::ostringstream bitmaps;
+    std::vector< size_t > offsets( static_cast< size_t >( lastCharacter - firstCharacter + 1 ) );
+    size_t offset = 0;
+    for ( int character = firstCharacter; character <= lastCharacter; ++character )
+    {
+        const auto* glyph = findGlyph( character );
+        if ( glyph == nullptr )
+        {
+            continue;
+        }
+
+        const auto bitmap = ConvertGlyph( *glyph, font.iAscent, height );
+        // One line per page row of the glyph
+        bitmaps << "    // " << character << "\n";
+        for ( size_t row = 0; glyph->iWidth != 0 && row < bitmap.size( ); row += glyph->iWidth )
+        {
+            bitmaps << "   ";
+            for ( int column = 0; column < glyph->iWidth; ++column )
+            {
+                char byte[ 8 ];
+                std::snprintf( byte, sizeof( byte ), " 0x%02X,", bitmap[ row + column ] );
+                bitmaps << byte;
+            }
+            bitmaps << "\n";
+        }
+        offsets[ character - firstCharacter ] = offset;
+        offset += bitmap.size( );
+    }
+    if ( offset == 0 )
+    {
+        // Keep the array non-empty for a font of the empty glyphs
+        bitmaps << "    0x00,\n";
+    }
+
+    std::ostringstream glyphs;
+    for ( int character = firstCharacter; character <= lastCharacter; ++character )
+    {
+        const auto* glyph = findGlyph( character );
+        const int source = glyph != nullptr ? character : defaultCharacter;
+        if ( glyph == nullptr )
+        {
+            glyph = findGlyph( defaultCharacter );
+        }
+        glyphs << "    TGlyph{ " << offsets[ source - firstCharacter ] << ", " << glyph->iWidth
+               << ", " << glyph->iXOffset << ", " << glyph->iAdvance << " },  // " << character
+               << "\n";
+    }
+
+    std::ofstream output{ outputPath };
+    output << "#pragma once\n"
+           << "// Generated by external-devices.ssd1306.font-converter from " << fontPath
+           << ", do not edit\n"
+           << "#include <ExternalHardware/ssd1306/SSD1306_Font.hpp>\n\n"
+           << "namespace ExternalHardware\n{\nnamespace Ssd1306\n{\nnamespace Fonts\n{\n"
+           << "inline constexpr std::uint8_t K" << name << "Bitmaps[] = {\n"
+           << bitmaps.str( ) << "};\n\n"
+           << "inline constexpr TGlyph K" << name << "Glyphs[] = {\n"
+           << glyphs.str( ) << "};\n\n";
+    if ( !kerningPairs.empty( ) )
+    {
+        output << "inline constexpr TKerningPair K" << name << "KerningPairs[] = {\n";
+        for ( const auto& pair : kerningPairs )
+        {
+            output << "    TKerningPair{ " << pair.iLeft << ", " << pair.iRight << ", "
+                   << pair.iAdjustment << " },\n";
+        }
+        output << "};\n\n";
+    }
+    output << "inline constexpr TFont K" << name << "{\n    " << height << ", "
+           << ( height + KPixelsPerPage - 1 ) / KPixelsPerPage << ", " << font.iAscent << ", "
+           << firstCharacter << ", " << lastCharacter << ", " << defaultCharacter << ",\n    K"
+           << name << "Glyphs,\n    K" << name << "Bitmaps,\n    "
+           << ( kerningPairs.empty( ) ? "nullptr" : "K" + name + "KerningPairs" ) << ", "
+           << kerningPairs.size( ) << " };\n"
+           << "}  // namespace Fonts\n}  // namespace Ssd1306\n}  // namespace ExternalHardware\n";
+
+    if ( !output )
+    {
+        std::fprintf( stderr, "Can't write %s\n", outputPath );
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}